@@ -62,6 +62,7 @@ void setup() {
     delay(3000);
     esp_restart();
   }
+  touchSetHoldFilter(displayCanHoldRepeat);
 
   // Initialize IMU
   if (!imuInit()) {
@@ -76,10 +77,7 @@ void setup() {
     esp_restart();
   }
 
-  // Initialize BLE (but don't start advertising yet)
-  if (!bleInit()) {
-    Serial.println("BLE init failed (non-fatal)");
-  }
+  // BLE stays down until it is switched on in settings (see bleStart())
 
   // Initialize battery monitor
   batteryInit();
@@ -91,7 +89,8 @@ void setup() {
   lastSampleTime = micros();
 
   Serial.println(getTimestamp());
-  Serial.println("Setup complete!");
+  Serial.printf("Setup complete in %lu ms, free heap %lu\n", millis(),
+                (unsigned long)ESP.getFreeHeap());
   Serial.println("-----------------------------\n");
 
   displaySplashScreen();
@@ -108,7 +107,10 @@ void setup() {
       TouchEvent ev = touchUpdate(tx, ty);
       if (ev == TOUCH_TAP) {
         displayDateTimePickerHandleTouch(tx, ty);
+      } else if (ev == TOUCH_HOLD_REPEAT) {
+        displayHandleHoldRepeat(tx, ty);
       }
+      displayRender();
       delay(10);
     }
 
@@ -142,7 +144,11 @@ void loop() {
 
         // Sync BLE state with toggle
         if (displayGetBleEnabled() && !bleIsActive()) {
-            bleStart();
+            if (!bleStart()) {
+                Serial.println("BLE start failed");
+                displaySetBleEnabled(false);
+                displayDrawBleButton();
+            }
         } else if (!displayGetBleEnabled() && bleIsActive()) {
             bleStop();
         }
@@ -157,7 +163,10 @@ void loop() {
                 TouchEvent ev = touchUpdate(tx, ty);
                 if (ev == TOUCH_TAP) {
                     displayDateTimePickerHandleTouch(tx, ty);
+                } else if (ev == TOUCH_HOLD_REPEAT) {
+                    displayHandleHoldRepeat(tx, ty);
                 }
+                displayRender();
                 delay(10);
             }
 
@@ -182,7 +191,7 @@ void loop() {
         }
     } else if (event == TOUCH_TAP) {
       // Short tap - toggle workout
-      if (touchInButton(touchX, touchY)) {
+      if (displayMainHandleTouch(touchX, touchY)) {
         if (workoutIsRunning()) {
           // Stop workout and save data
           workoutSave();
@@ -200,6 +209,21 @@ void loop() {
     }
   }
 
+  // Drags, flicks and hold-repeat go to whatever screen is up; a
+  // horizontal swipe is a flick that went far enough to have a direction
+  if (event == TOUCH_DRAG || event == TOUCH_FLICK ||
+      event == TOUCH_SWIPE_LEFT || event == TOUCH_SWIPE_RIGHT) {
+    TouchInfo info;
+    touchGetInfo(&info);
+    if (event == TOUCH_DRAG) {
+      displayHandleDrag(info.startX, info.startY, info.x, info.dx, info.horizontal);
+    } else {
+      displayHandleFlick(info.startX, info.startY, info.vx, info.horizontal);
+    }
+  } else if (event == TOUCH_HOLD_REPEAT) {
+    displayHandleHoldRepeat(touchX, touchY);
+  }
+
   // Process IMU data when workout is running
 if (workoutIsRunning()) {
   unsigned long currentTime = micros();
@@ -222,9 +246,17 @@ if (workoutIsRunning()) {
     }
   }
 
+  // Paint whatever changed on screen
+  displayRender();
+
   // Handle BLE events
   bleUpdate();
 
+  // Log retention and compaction, one small step at a time while idle
+  if (!workoutIsRunning()) {
+    storageMaintain();
+  }
+
   // Small delay for stability
   delay(5);
 }
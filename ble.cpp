@@ -1,40 +1,440 @@
 #include "ble.h"
 #include "config.h"
 #include "storage.h"
+#include "proto.h"
+#include "workout.h"
+#include "battery.h"
+#include "sound.h"
+#include "telemetry.h"
 #include <NimBLEDevice.h>
 
 static NimBLEServer* pServer = nullptr;
 static NimBLECharacteristic* pTxCharacteristic = nullptr;
 static NimBLECharacteristic* pRxCharacteristic = nullptr;
+static NimBLECharacteristic* pLiveCharacteristic = nullptr;
 static bool bleActive = false;
+static bool stackUp = false;      // NimBLE initialized (first bleStart() until bleStop())
 static bool deviceConnected = false;
 static bool oldDeviceConnected = false;
+static volatile bool syncRequested = false;
+static volatile bool pongRequested = false;
+static volatile bool ackReceived = false;
+static volatile uint32_t syncFromSeq = 0;   // Requested start, SYNC_FROM_PEER = stored cursor
+static volatile uint32_t ackSeq = 0;
+static uint16_t connHandle = 0;
+static uint8_t connAddr[6];
+static volatile bool connIdStable = false;   // connAddr is an identity, not a private address
+
+// Identity: low 32 bits of the factory MAC, also in the device name
+static uint32_t deviceId = 0;
+static char deviceName[16];
+
+// Advertising restart after a disconnect (scheduled, never waited on)
+static bool advRestartPending = false;
+static unsigned long advRestartAtMs = 0;
+
+// Last rep, for the advertised summary
+static uint16_t advRepPeak = 0;
+static uint16_t advRepMean = 0;
+
+// Binary protocol (proto.h): used once the phone sends a valid frame
+static bool binaryMode = false;
+static volatile bool liveSubscribed = false;   // Notifications enabled on the live characteristic
+static uint16_t txFrameSeq = 0;
+static uint16_t rxFrameSeq = 0;
+
+// Last binary request, handed from the write callback to bleUpdate()
+static uint8_t rxFrame[BLE_PREFERRED_MTU];
+static volatile uint16_t rxFrameLen = 0;   // Non-zero while one is waiting
+
+#define SYNC_FROM_PEER 0xFFFFFFFFu
+
+// ============== Per-peer sync cursors ==============
+// Each phone's last acknowledged row, persisted so an interrupted sync
+// resumes where it stopped. Least recently used entry is replaced.
+// Phones are bonded, so the key is their identity address rather than a
+// private address that changes on every reconnect. Only an ACK from such a
+// phone takes a slot; anything else (a hub asking for INFO) just reads.
+
+typedef struct {
+    uint8_t addr[6];
+    uint32_t ackedSeq;   // Rows below this are on that phone
+    uint32_t lastUsed;   // Bumped on every use, for replacement
+} PeerCursor;
+
+static PeerCursor peers[BLE_MAX_PEERS];
+static uint32_t peerClock = 0;
+
+static void peersLoad() {
+    if (!readFileBytes(BLE_PEERS_FILE, peers, sizeof(peers))) {
+        memset(peers, 0, sizeof(peers));
+    }
+    for (int i = 0; i < BLE_MAX_PEERS; i++) {
+        if (peers[i].lastUsed > peerClock) peerClock = peers[i].lastUsed;
+    }
+}
+
+// Cursor of a known phone, or null
+static PeerCursor* peerLookup(const uint8_t* addr) {
+    for (int i = 0; i < BLE_MAX_PEERS; i++) {
+        if (memcmp(peers[i].addr, addr, 6) == 0 && peers[i].lastUsed != 0) return &peers[i];
+    }
+    return nullptr;
+}
+
+// Where a sync for this phone resumes; 0 for one we have no cursor for
+static uint32_t peerAckedSeq(const uint8_t* addr) {
+    PeerCursor* peer = peerLookup(addr);
+    return peer ? peer->ackedSeq : 0;
+}
+
+// Cursor of a phone, taking the least recently used slot for a new one
+static PeerCursor* peerFind(const uint8_t* addr) {
+    PeerCursor* peer = peerLookup(addr);
+    if (peer) {
+        peer->lastUsed = ++peerClock;
+        return peer;
+    }
+
+    PeerCursor* oldest = &peers[0];
+    for (int i = 1; i < BLE_MAX_PEERS; i++) {
+        if (peers[i].lastUsed < oldest->lastUsed) oldest = &peers[i];
+    }
+    memcpy(oldest->addr, addr, 6);
+    oldest->ackedSeq = 0;
+    oldest->lastUsed = ++peerClock;
+    return oldest;
+}
+
+// Rows below this are on every phone we still track. A phone that was
+// replaced out of the table no longer holds rows back.
+static uint32_t peersMinAcked() {
+    uint32_t minSeq = 0xFFFFFFFFu;
+    for (int i = 0; i < BLE_MAX_PEERS; i++) {
+        if (peers[i].lastUsed != 0 && peers[i].ackedSeq < minSeq) minSeq = peers[i].ackedSeq;
+    }
+    return minSeq == 0xFFFFFFFFu ? 0 : minSeq;
+}
+
+// Largest notification payload for the current link (ATT_MTU - 3)
+static volatile uint16_t txPayload = BLE_DEFAULT_PAYLOAD;
+
+// ============== Transmit queue ==============
+// bleSend() packs bytes into fixed frames; txPump() hands them to NimBLE
+// while the host has mbufs to spare. NimBLE reports a notification's
+// status from inside notify() itself, so there is no later "sent" event to
+// pace on; the free mbuf count is the only backpressure. Nothing here
+// allocates; ENOMEM just leaves the frame queued and backs off.
+
+typedef struct {
+    uint16_t len;
+    uint8_t data[BLE_PREFERRED_MTU - 3];
+} TxFrame;
+
+static TxFrame txQueue[BLE_TX_QUEUE_LEN];
+static uint8_t txHead = 0;          // Oldest frame
+static uint8_t txCount = 0;         // Frames in use (last one may be partial)
+static bool txPumping = false;      // One pumper at a time
+static unsigned long txRetryAtUs = 0;
+static bool txRetryPending = false;
+static portMUX_TYPE txMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Counters for throughput debugging
+static uint32_t txNotifies = 0;
+static uint32_t txNoMem = 0;
+
+static void txReset() {
+    portENTER_CRITICAL(&txMux);
+    txHead = 0;
+    txCount = 0;
+    txRetryPending = false;
+    portEXIT_CRITICAL(&txMux);
+}
+
+// Copy as much of data as fits into the queue, returns bytes taken
+static size_t txEnqueue(const uint8_t* data, size_t len) {
+    size_t taken = 0;
+    uint16_t payload = txPayload;
+
+    portENTER_CRITICAL(&txMux);
+    while (taken < len) {
+        TxFrame* f = nullptr;
+        if (txCount > 0) {
+            f = &txQueue[(txHead + txCount - 1) % BLE_TX_QUEUE_LEN];
+            // Never append to the frame that is being handed to the stack
+            if (f->len >= payload || (txCount == 1 && txPumping)) f = nullptr;
+        }
+        if (f == nullptr) {
+            if (txCount == BLE_TX_QUEUE_LEN) break;
+            f = &txQueue[(txHead + txCount) % BLE_TX_QUEUE_LEN];
+            f->len = 0;
+            txCount++;
+        }
+
+        size_t n = min((size_t)(payload - f->len), len - taken);
+        memcpy(f->data + f->len, data + taken, n);
+        f->len += n;
+        taken += n;
+    }
+    portEXIT_CRITICAL(&txMux);
+
+    return taken;
+}
+
+// Bytes txEnqueue() would take right now
+static size_t txFreeBytes() {
+    uint16_t payload = txPayload;
+
+    portENTER_CRITICAL(&txMux);
+    size_t free = (size_t)(BLE_TX_QUEUE_LEN - txCount) * payload;
+    if (txCount > 0) {
+        TxFrame* f = &txQueue[(txHead + txCount - 1) % BLE_TX_QUEUE_LEN];
+        if (f->len < payload && !(txCount == 1 && txPumping)) free += payload - f->len;
+    }
+    portEXIT_CRITICAL(&txMux);
+
+    return free;
+}
+
+// Notify queued frames while the stack has room. Partial frames are only
+// sent when flushing, so consecutive small writes share a notification.
+static void txPump(bool flush) {
+    if (!deviceConnected || !pTxCharacteristic) return;
+    if (txRetryPending && (long)(micros() - txRetryAtUs) < 0) return;
+    txRetryPending = false;
+
+    portENTER_CRITICAL(&txMux);
+    if (txPumping) {
+        portEXIT_CRITICAL(&txMux);
+        return;
+    }
+    txPumping = true;
+    portEXIT_CRITICAL(&txMux);
+
+    while (true) {
+        portENTER_CRITICAL(&txMux);
+        TxFrame* f = (txCount > 0) ? &txQueue[txHead] : nullptr;
+        bool ready = f && (flush || txCount > 1 || f->len >= txPayload);
+        portEXIT_CRITICAL(&txMux);
+
+        if (!ready || os_msys_num_free() < BLE_TX_MIN_MBUFS) break;
+
+        if (!pTxCharacteristic->notify(f->data, f->len, connHandle)) {
+            // Host out of buffers: keep the frame and try again shortly
+            txNoMem++;
+            txRetryPending = true;
+            txRetryAtUs = micros() + BLE_TX_RETRY_US;
+            break;
+        }
+
+        txNotifies++;
+        portENTER_CRITICAL(&txMux);
+        txHead = (txHead + 1) % BLE_TX_QUEUE_LEN;
+        txCount--;
+        portEXIT_CRITICAL(&txMux);
+    }
+
+    portENTER_CRITICAL(&txMux);
+    txPumping = false;
+    portEXIT_CRITICAL(&txMux);
+}
+
+static void liveReset();
 
 // Static callback instances to avoid memory issues
 class ServerCallbacks : public NimBLEServerCallbacks {
     void onConnect(NimBLEServer* pServer, NimBLEConnInfo& connInfo) override {
         Serial.println("BLE: onConnect called");
+        connHandle = connInfo.getConnHandle();
+        // A bonded phone's private address is already resolved here; a new
+        // one's is not until pairing completes (onAuthenticationComplete)
+        memcpy(connAddr, connInfo.getIdAddress().getVal(), sizeof(connAddr));
+        connIdStable = !connInfo.getIdAddress().isRpa();
+        txPayload = BLE_DEFAULT_PAYLOAD;
+        txReset();
+        binaryMode = false;
+        liveSubscribed = false;
+        txFrameSeq = 0;
+        rxFrameSeq = 0;
+        rxFrameLen = 0;
+        liveReset();
         deviceConnected = true;
+        advRestartPending = false;
+
+        // Ask for the fastest packets the peer will give us; each request is
+        // best effort and the peer may refuse or pick something smaller.
+        // The interval stays relaxed until a sync needs it.
+        pServer->setDataLen(connHandle, BLE_DLE_TX_OCTETS);
+        ble_gap_set_prefered_le_phy(connHandle, BLE_GAP_LE_PHY_2M_MASK, BLE_GAP_LE_PHY_2M_MASK,
+                                    BLE_GAP_LE_PHY_CODED_ANY);
+        pServer->updateConnParams(connHandle, BLE_IDLE_ITVL_MIN, BLE_IDLE_ITVL_MAX,
+                                  BLE_IDLE_LATENCY, BLE_IDLE_TIMEOUT);
+        ble_gattc_exchange_mtu(connHandle, nullptr, nullptr);
+        NimBLEDevice::startSecurity(connHandle);
+    }
+
+    void onAuthenticationComplete(NimBLEConnInfo& connInfo) override {
+        if (!connInfo.isBonded()) {
+            Serial.println("BLE: pairing failed, sync cursor not kept for this phone");
+            return;
+        }
+        memcpy(connAddr, connInfo.getIdAddress().getVal(), sizeof(connAddr));
+        connIdStable = !connInfo.getIdAddress().isRpa();
+        Serial.println("BLE: bonded");
+    }
+
+    void onMTUChange(uint16_t MTU, NimBLEConnInfo& connInfo) override {
+        uint16_t payload = MTU - 3;
+        if (payload > BLE_PREFERRED_MTU - 3) payload = BLE_PREFERRED_MTU - 3;
+        txPayload = payload;
+        Serial.printf("BLE: MTU %u, notify payload %u bytes\n", MTU, payload);
+    }
+
+    void onPhyUpdate(NimBLEConnInfo& connInfo, uint8_t txPhy, uint8_t rxPhy) override {
+        Serial.printf("BLE: PHY tx=%uM rx=%uM\n", txPhy == BLE_GAP_LE_PHY_2M ? 2 : 1,
+                      rxPhy == BLE_GAP_LE_PHY_2M ? 2 : 1);
     }
 
     void onDisconnect(NimBLEServer* pServer, NimBLEConnInfo& connInfo, int reason) override {
         Serial.printf("BLE: onDisconnect called, reason=%d\n", reason);
         deviceConnected = false;
+        liveSubscribed = false;
+        telemetrySetTrace(false);
+        txPayload = BLE_DEFAULT_PAYLOAD;
+    }
+};
+
+// ============== Live telemetry ==============
+// Rep summaries and the velocity trace go out on their own characteristic,
+// straight to the stack rather than behind queued log data. A rep's
+// latency is measured from detection to notify() returning, i.e. to the
+// hand-off to the host stack (its status callback runs inside notify(), so
+// there is no later point to measure without looking at connection events).
+
+static uint8_t liveFrameBuf[BLE_PREFERRED_MTU - 3];
+static uint16_t liveFrameSeq = 0;
+
+// Latency stats (detection to the notify() call, and to the stack taking it)
+static uint16_t liveLastRep = 0;
+static uint32_t liveQueueUs = 0;
+static uint32_t liveHandoffUs = 0;
+static bool liveHandoffNew = false;
+static uint32_t liveHandoffCount = 0;
+static uint64_t liveHandoffSumUs = 0;
+static uint32_t liveHandoffMaxUs = 0;
+
+class LiveCallbacks : public NimBLECharacteristicCallbacks {
+    void onSubscribe(NimBLECharacteristic* pCharacteristic, NimBLEConnInfo& connInfo,
+                     uint16_t subValue) override {
+        liveSubscribed = (subValue & 1) != 0;
+        if (!liveSubscribed) telemetrySetTrace(false);
+        Serial.printf("BLE: live telemetry %s\n", liveSubscribed ? "on" : "off");
     }
 };
 
+static void liveReset() {
+    liveFrameSeq = 0;
+}
+
+static bool liveNotify(uint8_t type, const uint8_t* payload, size_t len, uint32_t detectedUs) {
+    size_t cap = min((size_t)txPayload, sizeof(liveFrameBuf));
+    size_t n = protoEncode(type, liveFrameSeq, payload, len, liveFrameBuf, cap, false);
+    if (n == 0 || os_msys_num_free() < BLE_TX_MIN_MBUFS) return false;
+
+    uint32_t callUs = micros();
+    if (!pLiveCharacteristic->notify(liveFrameBuf, n, connHandle)) {
+        txNoMem++;
+        return false;
+    }
+
+    if (detectedUs != 0) {
+        liveQueueUs = callUs - detectedUs;
+        liveHandoffUs = micros() - detectedUs;
+        liveHandoffNew = true;
+    }
+    liveFrameSeq++;
+    return true;
+}
+
+// Rep summaries first, then a trace batch once it's full or old enough
+static void livePump() {
+    RepSummary rep;
+    if (!deviceConnected || !liveSubscribed) {
+        while (telemetryPeekRep(&rep)) {
+            advRepPeak = rep.peakMmS;
+            advRepMean = rep.meanMmS;
+            telemetryDropRep();
+        }
+        return;
+    }
+
+    while (telemetryPeekRep(&rep)) {
+        advRepPeak = rep.peakMmS;
+        advRepMean = rep.meanMmS;
+        uint8_t out[12];
+        protoPut16(out, rep.rep);
+        protoPut16(out + 2, rep.durationMs);
+        protoPut16(out + 4, rep.peakMmS);
+        protoPut16(out + 6, rep.meanMmS);
+        protoPut32(out + 8, rep.setTimeMs);
+        if (!liveNotify(PROTO_LIVE_REP, out, sizeof(out), rep.detectedUs)) return;
+
+        liveLastRep = rep.rep;
+        telemetryDropRep();
+    }
+
+    if (!telemetryTraceEnabled()) return;
+
+    // u16 index + u8 rate, then as many samples as fit one notification
+    size_t room = min((size_t)txPayload, sizeof(liveFrameBuf)) - PROTO_OVERHEAD - 3;
+    int16_t samples[(sizeof(liveFrameBuf) - PROTO_OVERHEAD - 3) / 2];
+    size_t maxSamples = room / 2;
+
+    uint16_t firstIdx;
+    uint32_t oldestMs;
+    size_t n = telemetryPeekTrace(samples, maxSamples, &firstIdx, &oldestMs);
+    if (n == 0) return;
+    if (n < maxSamples && millis() - oldestMs < TELEMETRY_TRACE_BATCH_MS) return;
+
+    uint8_t out[sizeof(liveFrameBuf) - PROTO_OVERHEAD];
+    protoPut16(out, firstIdx);
+    out[2] = TELEMETRY_TRACE_HZ;
+    for (size_t i = 0; i < n; i++) protoPut16(out + 3 + i * 2, (uint16_t)samples[i]);
+    if (liveNotify(PROTO_LIVE_TRACE, out, 3 + n * 2, 0)) telemetryDropTrace(n);
+}
+
 class RxCallbacks : public NimBLECharacteristicCallbacks {
     void onWrite(NimBLECharacteristic* pCharacteristic, NimBLEConnInfo& connInfo) override {
         Serial.println("BLE: onWrite called");
         std::string rxValue = pCharacteristic->getValue();
+
+        // Binary requests are one frame per write, decoded in bleUpdate()
+        if (rxValue.length() > 0 && (uint8_t)rxValue[0] == PROTO_MAGIC) {
+            if (rxFrameLen == 0 && rxValue.length() <= sizeof(rxFrame)) {
+                memcpy(rxFrame, rxValue.data(), rxValue.length());
+                rxFrameLen = rxValue.length();
+            } else {
+                Serial.println("BLE: request dropped, previous one still pending");
+            }
+            return;
+        }
+
         if (rxValue.length() > 0) {
             Serial.printf("BLE received: %s\n", rxValue.c_str());
+            binaryMode = false;
 
-            if (rxValue == "SYNC") {
+            // Streaming and file writes happen from bleUpdate(); never block the host task
+            const char* cmd = rxValue.c_str();
+            if (strncmp(cmd, "SYNC", 4) == 0 && (cmd[4] == '\0' || cmd[4] == ' ')) {
+                // "SYNC" resumes from this phone's cursor, "SYNC <seq>" starts at seq
+                syncFromSeq = cmd[4] ? strtoul(cmd + 5, nullptr, 10) : SYNC_FROM_PEER;
+                syncRequested = true;
                 Serial.println("BLE sync requested");
-                bleSendWorkoutLog();
+            } else if (strncmp(cmd, "ACK ", 4) == 0) {
+                ackSeq = strtoul(cmd + 4, nullptr, 10);
+                ackReceived = true;
             } else if (rxValue == "PING") {
-                bleSend("PONG\n");
+                pongRequested = true;
             }
         }
     }
@@ -43,19 +443,36 @@ class RxCallbacks : public NimBLECharacteristicCallbacks {
 // Static instances
 static ServerCallbacks serverCallbacks;
 static RxCallbacks rxCallbacks;
+static LiveCallbacks liveCallbacks;
 
 bool bleInit() {
+    if (stackUp) return true;
     Serial.println("BLE: Initializing...");
 
-    NimBLEDevice::init(BLE_DEVICE_NAME);
+    // getEfuseMac() holds the address with its first byte lowest. Bytes 0-2
+    // are the Espressif OUI, the same on every unit, so the ID is the NIC
+    // part (bytes 3-5) and the name its last two bytes in address order.
+    uint64_t mac = ESP.getEfuseMac();
+    deviceId = (uint32_t)((mac >> 24) & 0xFFFFFF);
+    snprintf(deviceName, sizeof(deviceName), "%s-%02X%02X", BLE_DEVICE_NAME,
+             (unsigned)((mac >> 32) & 0xFF), (unsigned)((mac >> 40) & 0xFF));
+
+    NimBLEDevice::init(deviceName);
+    NimBLEDevice::setMTU(BLE_PREFERRED_MTU);
+    // Just Works bonding (no display or keypad here), for a stable peer identity
+    NimBLEDevice::setSecurityIOCap(BLE_HS_IO_NO_INPUT_OUTPUT);
+    NimBLEDevice::setSecurityAuth(true, false, true);
     Serial.println("BLE: Device initialized");
 
+    peersLoad();
+
     pServer = NimBLEDevice::createServer();
     if (!pServer) {
         Serial.println("BLE: Failed to create server");
         return false;
     }
-    pServer->setCallbacks(&serverCallbacks);
+    pServer->setCallbacks(&serverCallbacks, false);   // Static instance, must not be deleted
+    pServer->advertiseOnDisconnect(false);   // Restarted from bleUpdate()
     Serial.println("BLE: Server created");
 
     NimBLEService* pService = pServer->createService(BLE_SERVICE_UUID);
@@ -86,36 +503,146 @@ bool bleInit() {
     pRxCharacteristic->setCallbacks(&rxCallbacks);
     Serial.println("BLE: RX characteristic created");
 
+    pLiveCharacteristic = pService->createCharacteristic(
+        BLE_LIVE_CHAR_UUID,
+        NIMBLE_PROPERTY::NOTIFY
+    );
+    if (!pLiveCharacteristic) {
+        Serial.println("BLE: Failed to create live characteristic");
+        return false;
+    }
+    pLiveCharacteristic->setCallbacks(&liveCallbacks);
+    Serial.println("BLE: Live characteristic created");
+
     pService->start();
     Serial.println("BLE: Service started");
 
+    stackUp = true;
     Serial.println("BLE: Initialized successfully");
     return true;
 }
 
-void bleStart() {
+// Tear the stack down and give its memory back
+static void bleRelease() {
+    NimBLEDevice::deinit(true);
+    pServer = nullptr;
+    pTxCharacteristic = nullptr;
+    pRxCharacteristic = nullptr;
+    pLiveCharacteristic = nullptr;
+    stackUp = false;
+}
+
+// ============== Advertising ==============
+// Manufacturer data lets a hub read every device without connecting; the
+// layout is ProtoAdv in proto.h. The device ID is MAC bytes 3-5.
+// Name and service UUID go in the scan response.
+
+static uint8_t advMfr[PROTO_ADV_LEN];
+static uint8_t advCounter = 0;
+static unsigned long advLastUpdateMs = 0;
+
+static void advSetData() {
+    NimBLEAdvertisementData data;
+    data.setFlags(BLE_HS_ADV_F_DISC_GEN | BLE_HS_ADV_F_BREDR_UNSUP);
+    data.setManufacturerData(advMfr, sizeof(advMfr));
+    NimBLEDevice::getAdvertising()->setAdvertisementData(data);
+}
+
+// Rebuild the summary; returns true if it changed
+static bool advBuild() {
+    ProtoAdv adv;
+    adv.companyId = BLE_COMPANY_ID;
+    adv.deviceId = deviceId;
+    adv.counter = advCounter;
+    adv.flags = 0;
+    if (workoutIsRunning()) adv.flags |= PROTO_ADV_RUNNING;
+    if (workoutIsSetActive()) adv.flags |= PROTO_ADV_SET_ACTIVE;
+    if (batteryIsCharging()) adv.flags |= PROTO_ADV_CHARGING;
+    if (storageLogSyncedSeq() < storageLogNextSeq()) adv.flags |= PROTO_ADV_UNSYNCED;
+    adv.battery = (uint8_t)batteryGetPercent();
+    adv.reps = (uint16_t)workoutGetReps();
+    adv.peakMmS = advRepPeak;
+    adv.meanMmS = advRepMean;
+
+    uint8_t m[PROTO_ADV_LEN];
+    protoAdvEncode(&adv, m);
+    if (memcmp(m, advMfr, sizeof(m)) == 0) return false;
+
+    adv.counter = ++advCounter;
+    protoAdvEncode(&adv, advMfr);
+    return true;
+}
+
+static void advConfigure() {
+    NimBLEAdvertising* pAdvertising = NimBLEDevice::getAdvertising();
+
+    advBuild();
+    advSetData();
+
+    NimBLEAdvertisementData scan;
+    scan.setName(deviceName);
+    scan.setCompleteServices(BLE_SERVICE_UUID);
+    pAdvertising->setScanResponseData(scan);
+    pAdvertising->enableScanResponse(true);
+
+    pAdvertising->setMinInterval(BLE_ADV_ITVL_MIN);
+    pAdvertising->setMaxInterval(BLE_ADV_ITVL_MAX);
+    advLastUpdateMs = millis();
+}
+
+// Keep the advertised summary current, at most once per BLE_ADV_UPDATE_MS
+static void advUpdate() {
+    if (!bleActive || deviceConnected) return;
+    if (millis() - advLastUpdateMs < BLE_ADV_UPDATE_MS) return;
+    advLastUpdateMs = millis();
+
+    if (advBuild()) advSetData();
+}
+
+bool bleStart() {
     if (bleActive) {
         Serial.println("BLE: Already active");
-        return;
+        return true;
+    }
+
+    // The stack only comes up when BLE is first switched on
+    if (!stackUp) {
+        unsigned long startMs = millis();
+        uint32_t heapBefore = ESP.getFreeHeap();
+        if (!bleInit()) {
+            bleRelease();
+            return false;
+        }
+        Serial.printf("BLE: stack up in %lu ms, free heap %lu -> %lu\n", millis() - startMs,
+                      (unsigned long)heapBefore, (unsigned long)ESP.getFreeHeap());
     }
 
     Serial.println("BLE: Starting advertising...");
-    NimBLEAdvertising* pAdvertising = NimBLEDevice::getAdvertising();
-    pAdvertising->addServiceUUID(BLE_SERVICE_UUID);
-    pAdvertising->start();
+    advConfigure();
+    NimBLEDevice::getAdvertising()->start();
 
     bleActive = true;
-    Serial.println("BLE: Advertising started");
+    Serial.printf("BLE: Advertising as %s (ID %08lX)\n", deviceName, (unsigned long)deviceId);
+    return true;
 }
 
 void bleStop() {
     if (!bleActive) return;
 
     Serial.println("BLE: Stopping...");
+    uint32_t heapBefore = ESP.getFreeHeap();
     NimBLEDevice::getAdvertising()->stop();
+    advRestartPending = false;
     bleActive = false;
     deviceConnected = false;
-    Serial.println("BLE: Stopped");
+    liveSubscribed = false;
+    telemetrySetTrace(false);
+    txReset();
+
+    // A running sync sees the disconnect on the next bleUpdate() and closes its cursor
+    bleRelease();
+    Serial.printf("BLE: Stopped, free heap %lu -> %lu\n", (unsigned long)heapBefore,
+                  (unsigned long)ESP.getFreeHeap());
 }
 
 bool bleIsActive() {
@@ -126,62 +653,497 @@ bool bleIsConnected() {
     return deviceConnected;
 }
 
-size_t bleSend(const char* data) {
+size_t bleSend(const uint8_t* data, size_t len) {
     if (!deviceConnected || !pTxCharacteristic) return 0;
 
-    size_t len = strlen(data);
-    const size_t chunkSize = 20;
-    size_t sent = 0;
+    size_t taken = txEnqueue(data, len);
+    txPump(false);
+    return taken;
+}
+
+size_t bleSend(const char* data) {
+    return bleSend((const uint8_t*)data, strlen(data));
+}
+
+size_t bleSend(const String& data) {
+    return bleSend(data.c_str());
+}
+
+void bleFlush() {
+    txPump(true);
+}
+
+// Queue one binary frame, whole or not at all. Returns the bytes queued.
+static uint8_t txFrameBuf[BLE_PREFERRED_MTU - 3];
+
+static size_t bleSendFrame(uint8_t type, const uint8_t* payload, size_t len, bool lz) {
+    if (!deviceConnected) return 0;
+    if (txFreeBytes() < len + PROTO_OVERHEAD) return 0;
+
+    size_t n = protoEncode(type, txFrameSeq, payload, len, txFrameBuf, sizeof(txFrameBuf), lz);
+    if (n == 0) return 0;
+
+    txEnqueue(txFrameBuf, n);
+    txFrameSeq++;
+    txPump(false);
+    return n;
+}
+
+static void bleSendStatus(uint8_t type, uint8_t code) {
+    uint8_t payload[2] = {type, code};
+    bleSendFrame(PROTO_STATUS, payload, sizeof(payload), false);
+}
+
+// ============== Log sync ==============
+// A sync walks the log with a storage cursor and is pumped from bleUpdate(),
+// a few frames per loop iteration, so sampling and the UI keep running.
+
+typedef enum {
+    SYNC_IDLE,
+    SYNC_ROWS,   // Streaming rows from the cursor
+    SYNC_DRAIN   // END_LOG queued, waiting for the queue to empty
+} SyncState;
+
+static SyncState syncState = SYNC_IDLE;
+static StorageCursor syncCursor;
+static uint32_t syncEndSeq = 0;
+
+// Rest of the current line that didn't fit in the queue yet:
+// owned text (seq column, BEGIN/END lines), then a view into the cursor
+static char syncText[32];
+static const char* syncTextPos = nullptr;
+static size_t syncTextLen = 0;
+static const char* syncPending = nullptr;
+static size_t syncPendingLen = 0;
+static bool syncPendingNewline = false;
+
+// Binary syncs pack lines into SYNC_DATA frames; this is the one being filled
+static bool syncBinary = false;
+static uint8_t syncFrame[BLE_PREFERRED_MTU - 3 - PROTO_OVERHEAD];
+static size_t syncFrameLen = 0;
+
+// Control frame (BEGIN/END) waiting behind the buffered rows
+static uint8_t syncCtrlType = 0;
+static uint8_t syncCtrl[8];
+static uint8_t syncCtrlLen = 0;
+
+// Throughput and loop jitter while syncing
+static unsigned long syncStartMs = 0;
+static size_t syncBytes = 0;
+static size_t syncWireBytes = 0;
+static uint32_t syncNoMemBefore = 0;
+static unsigned long syncLastUpdateUs = 0;
+static unsigned long syncMaxPeriodUs = 0;
+static unsigned long syncMaxPumpUs = 0;
+static uint32_t syncUpdates = 0;
+static uint64_t syncPeriodSumUs = 0;
+
+static void syncSetText(const char* fmt, unsigned long a, unsigned long b) {
+    int n = snprintf(syncText, sizeof(syncText), fmt, a, b);
+    syncTextPos = syncText;
+    syncTextLen = (n > 0) ? min((size_t)n, sizeof(syncText) - 1) : 0;
+}
+
+static void syncSetCtrl(uint8_t type, uint32_t a, uint32_t b, uint8_t len) {
+    syncCtrlType = type;
+    protoPut32(syncCtrl, a);
+    protoPut32(syncCtrl + 4, b);
+    syncCtrlLen = len;
+}
+
+static bool syncSendFrame(uint8_t type, const uint8_t* payload, size_t len, bool lz) {
+    size_t n = bleSendFrame(type, payload, len, lz);
+    syncWireBytes += n;
+    return n > 0;
+}
 
-    while (sent < len) {
-        size_t remaining = len - sent;
-        size_t toSend = (remaining > chunkSize) ? chunkSize : remaining;
+// Frames no bigger than a notification once the MTU is up, a few
+// notifications each on a default link to keep the overhead down
+static size_t syncFrameCap() {
+    size_t cap = max((size_t)txPayload, (size_t)64) - PROTO_OVERHEAD;
+    return min(cap, sizeof(syncFrame));
+}
 
-        pTxCharacteristic->setValue((uint8_t*)(data + sent), toSend);
-        pTxCharacteristic->notify();
-        sent += toSend;
+static bool syncFlushFrame() {
+    if (syncFrameLen == 0) return true;
+    if (!syncSendFrame(PROTO_SYNC_DATA, syncFrame, syncFrameLen, true)) return false;
+    syncFrameLen = 0;
+    return true;
+}
 
-        delay(10);
+// Queue log text, as is or packed into SYNC_DATA frames; returns bytes taken
+static size_t syncEmit(const uint8_t* data, size_t len) {
+    if (!syncBinary) {
+        size_t n = bleSend(data, len);
+        syncWireBytes += n;
+        return n;
     }
 
-    return sent;
+    size_t taken = 0;
+    while (taken < len) {
+        size_t cap = syncFrameCap();
+        if (syncFrameLen >= cap && !syncFlushFrame()) break;
+
+        size_t n = min(cap - syncFrameLen, len - taken);
+        memcpy(syncFrame + syncFrameLen, data + taken, n);
+        syncFrameLen += n;
+        taken += n;
+    }
+    return taken;
 }
 
-size_t bleSend(const String& data) {
-    return bleSend(data.c_str());
+// Queue as much of the pending line as fits, returns true when it's all in
+static bool syncSendPending() {
+    if (syncTextLen > 0) {
+        size_t n = syncEmit((const uint8_t*)syncTextPos, syncTextLen);
+        syncTextPos += n;
+        syncTextLen -= n;
+        syncBytes += n;
+        if (syncTextLen > 0) return false;
+    }
+    if (syncPendingLen > 0) {
+        size_t n = syncEmit((const uint8_t*)syncPending, syncPendingLen);
+        syncPending += n;
+        syncPendingLen -= n;
+        syncBytes += n;
+        if (syncPendingLen > 0) return false;
+    }
+    if (syncPendingNewline) {
+        if (syncEmit((const uint8_t*)"\n", 1) == 0) return false;
+        syncPendingNewline = false;
+        syncBytes++;
+    }
+    if (syncCtrlType) {
+        if (!syncFlushFrame()) return false;
+        if (!syncSendFrame(syncCtrlType, syncCtrl, syncCtrlLen, false)) return false;
+        syncCtrlType = 0;
+    }
+    return true;
+}
+
+// Fast interval for bulk transfer, relaxed otherwise
+static void linkSetFast(bool fast) {
+    if (!deviceConnected) return;
+    if (fast) {
+        pServer->updateConnParams(connHandle, BLE_CONN_ITVL_MIN, BLE_CONN_ITVL_MAX, 0, BLE_CONN_TIMEOUT);
+    } else {
+        pServer->updateConnParams(connHandle, BLE_IDLE_ITVL_MIN, BLE_IDLE_ITVL_MAX,
+                                  BLE_IDLE_LATENCY, BLE_IDLE_TIMEOUT);
+    }
+}
+
+static void syncFinish(bool complete) {
+    storageCursorClose(&syncCursor);
+    linkSetFast(false);
+    syncState = SYNC_IDLE;
+    syncTextLen = 0;
+    syncPendingLen = 0;
+    syncPendingNewline = false;
+    syncFrameLen = 0;
+    syncCtrlType = 0;
+
+    if (!complete) {
+        Serial.println("BLE: log sync aborted");
+        return;
+    }
+
+    unsigned long elapsedMs = millis() - syncStartMs;
+    Serial.printf("Workout log sent: %u bytes (%u on air) in %lu ms (%.1f KB/s, %u-byte notifications, %lu ENOMEM)\n",
+                  (unsigned)syncBytes, (unsigned)syncWireBytes, elapsedMs,
+                  elapsedMs ? syncBytes / 1.024f / elapsedMs : 0.0f, txPayload,
+                  (unsigned long)(txNoMem - syncNoMemBefore));
+    Serial.printf("Loop during sync: %lu updates, period avg %lu us / max %lu us, sync pump max %lu us\n",
+                  (unsigned long)syncUpdates,
+                  syncUpdates ? (unsigned long)(syncPeriodSumUs / syncUpdates) : 0UL,
+                  syncMaxPeriodUs, syncMaxPumpUs);
+}
+
+// The phone has every row below seq: move its cursor. Retention only
+// advances to the slowest known phone, so one phone's ack never lets the
+// log drop rows another has not fetched yet.
+static void syncHandleAck(uint32_t seq) {
+    uint32_t next = storageLogNextSeq();
+    if (seq > next) seq = next;
+
+    // A phone that acks nothing, or that we could not identify, gets no
+    // slot; a new cursor at 0 would hold every row back
+    if (!connIdStable) {
+        Serial.println("BLE: ack from an unbonded phone, cursor not kept");
+        return;
+    }
+    PeerCursor* peer = seq > 0 ? peerFind(connAddr) : peerLookup(connAddr);
+    if (peer && seq > peer->ackedSeq) {
+        peer->ackedSeq = seq;
+        writeFileBytes(BLE_PEERS_FILE, peers, sizeof(peers));
+    }
+    uint32_t synced = peersMinAcked();
+    storageLogMarkSynced(synced);
+    Serial.printf("BLE: peer acked rows < %lu (all peers < %lu)\n",
+                  (unsigned long)seq, (unsigned long)synced);
+}
+
+// Move up to BLE_SYNC_FRAMES_PER_UPDATE frames' worth of log into the queue
+static void syncPump() {
+    unsigned long startUs = micros();
+    if (syncLastUpdateUs != 0) {
+        unsigned long period = startUs - syncLastUpdateUs;
+        if (period > syncMaxPeriodUs) syncMaxPeriodUs = period;
+        syncPeriodSumUs += period;
+        syncUpdates++;
+    }
+    syncLastUpdateUs = startUs;
+
+    if (!deviceConnected) {
+        syncFinish(false);
+        return;
+    }
+
+    if (syncState == SYNC_ROWS) {
+        size_t budget = (size_t)BLE_SYNC_FRAMES_PER_UPDATE * txPayload;
+        size_t queuedBefore = syncBytes;
+
+        while (syncBytes - queuedBefore < budget) {
+            if (!syncSendPending()) break;
+
+            StorageLine line;
+            if (!storageCursorNext(&syncCursor, &line)) {
+                storageCursorClose(&syncCursor);
+                if (syncBinary) {
+                    syncSetCtrl(PROTO_SYNC_END, syncEndSeq, 0, 4);
+                } else {
+                    syncSetText("END_LOG %lu", syncEndSeq, 0);
+                    syncPendingNewline = true;
+                }
+                syncState = SYNC_DRAIN;
+                break;
+            }
+            // The header always goes out; rows stop at what existed at SYNC time
+            if (!line.header && line.seq >= syncEndSeq) continue;
+
+            // Rows carry their sequence number as an extra first column
+            if (line.header) {
+                syncSetText("seq,", 0, 0);
+            } else {
+                syncSetText("%lu,", line.seq, 0);
+            }
+            syncPending = line.data;
+            syncPendingLen = line.len;
+            syncPendingNewline = true;
+        }
+    }
+
+    if (syncState == SYNC_DRAIN && syncSendPending()) {
+        txPump(true);
+        if (txCount == 0) syncFinish(true);
+    }
+
+    unsigned long pumpUs = micros() - startUs;
+    if (pumpUs > syncMaxPumpUs) syncMaxPumpUs = pumpUs;
+}
+
+static void syncReject(uint8_t code) {
+    if (binaryMode) {
+        bleSendStatus(PROTO_SYNC, code);
+    } else if (code == PROTO_ERR_NO_DATA) {
+        bleSend("NO_DATA\n");
+    }
 }
 
-bool bleSendWorkoutLog() {
+bool bleSendWorkoutLog(uint32_t fromSeq) {
     if (!deviceConnected) {
         Serial.println("Cannot send log: not connected");
         return false;
     }
+    if (syncState != SYNC_IDLE) {
+        Serial.println("BLE: sync already running");
+        syncReject(PROTO_ERR_BUSY);
+        return false;
+    }
 
-    if (!fileExists(LOGFILE)) {
-        bleSend("NO_DATA\n");
-        Serial.println("No workout log file exists");
+    syncEndSeq = storageLogNextSeq();
+    if (fromSeq < storageLogFirstSeq()) fromSeq = storageLogFirstSeq();
+    if (fromSeq >= syncEndSeq) {
+        syncReject(PROTO_ERR_NO_DATA);
+        Serial.println("No new workout log rows");
         return false;
     }
 
-    Serial.println("Sending workout log over BLE...");
-    bleSend("BEGIN_LOG\n");
+    if (!storageCursorOpen(&syncCursor, fromSeq)) {
+        syncReject(PROTO_ERR_NO_DATA);
+        return false;
+    }
+
+    Serial.printf("Sending workout log rows %lu..%lu over BLE...\n",
+                  (unsigned long)fromSeq, (unsigned long)syncEndSeq);
+    syncStartMs = millis();
+    syncBytes = 0;
+    syncWireBytes = 0;
+    syncNoMemBefore = txNoMem;
+    syncLastUpdateUs = 0;
+    syncMaxPeriodUs = 0;
+    syncMaxPumpUs = 0;
+    syncUpdates = 0;
+    syncPeriodSumUs = 0;
+
+    linkSetFast(true);
+    syncBinary = binaryMode;
+    syncFrameLen = 0;
+    syncPendingLen = 0;
+    if (syncBinary) {
+        syncSetCtrl(PROTO_SYNC_BEGIN, fromSeq, syncEndSeq, 8);
+    } else {
+        syncSetText("BEGIN_LOG %lu %lu", fromSeq, syncEndSeq);
+        syncPendingNewline = true;
+    }
+    syncState = SYNC_ROWS;
+    return true;
+}
+
+bool bleSyncInProgress() {
+    return syncState != SYNC_IDLE;
+}
+
+// ============== Binary requests ==============
+
+static void protoHandle(const uint8_t* buf, size_t len) {
+    ProtoFrame f;
+    int rc = protoDecode(buf, len, &f);
+    if (rc != PROTO_DECODE_OK) {
+        Serial.printf("BLE: bad frame (%d, %u bytes)\n", rc, (unsigned)len);
+        bleSendStatus(0, PROTO_ERR_FRAME);
+        return;
+    }
+
+    binaryMode = true;
+    if (f.seq != rxFrameSeq) {
+        Serial.printf("BLE: request seq %u, expected %u\n", f.seq, rxFrameSeq);
+    }
+    rxFrameSeq = f.seq + 1;
+
+    // Requests are small; only the device compresses
+    if (f.compressed) {
+        bleSendStatus(f.type, PROTO_ERR_ARG);
+        return;
+    }
+
+    uint8_t out[32];
+    switch (f.type) {
+        case PROTO_PING:
+            bleSendFrame(PROTO_PONG, f.payload, min((size_t)f.len, sizeof(out)), false);
+            break;
+
+        case PROTO_INFO_GET: {
+            out[0] = PROTO_VERSION;
+            out[1] = (uint8_t)batteryGetPercent();
+            protoPut16(out + 2, (uint16_t)batteryGetVoltage());
+            protoPut16(out + 4, txPayload);
+            protoPut32(out + 6, storageLogFirstSeq());
+            protoPut32(out + 10, storageLogNextSeq());
+            protoPut32(out + 14, storageLogSyncedSeq());
+            protoPut32(out + 18, peerAckedSeq(connAddr));
+            bleSendFrame(PROTO_INFO, out, 22, false);
+            break;
+        }
+
+        case PROTO_SYNC:
+            if (f.len != 0 && f.len != 4) {
+                bleSendStatus(f.type, PROTO_ERR_ARG);
+                break;
+            }
+            bleSendWorkoutLog(f.len ? protoGet32(f.payload) : peerAckedSeq(connAddr));
+            break;
+
+        case PROTO_ACK:
+            if (f.len != 4) {
+                bleSendStatus(f.type, PROTO_ERR_ARG);
+                break;
+            }
+            syncHandleAck(protoGet32(f.payload));
+            break;
 
-    bool success = readFileByLine(LOGFILE, [](const String& line) {
-        bleSend(line + "\n");
-    });
+        case PROTO_LIVE_SUB:
+            if (f.len != 1) {
+                bleSendStatus(f.type, PROTO_ERR_ARG);
+                break;
+            }
+            telemetrySetTrace(f.payload[0] != 0);
+            bleSendStatus(f.type, PROTO_OK);
+            break;
 
-    bleSend("END_LOG\n");
-    Serial.println("Workout log sent");
+        case PROTO_SETTINGS_SET:
+            if (f.len != 2 || f.payload[0] < 1 || f.payload[0] > 100 || f.payload[1] > 100) {
+                bleSendStatus(f.type, PROTO_ERR_ARG);
+                break;
+            }
+            workoutSetSensitivity(f.payload[0]);
+            setVolume(f.payload[1]);
+            [[fallthrough]];  // Reply with what was applied
+        case PROTO_SETTINGS_GET:
+            out[0] = (uint8_t)getImuSensitivity();
+            out[1] = getVolume();
+            bleSendFrame(PROTO_SETTINGS, out, 2, false);
+            break;
 
-    return success;
+        default:
+            bleSendStatus(f.type, PROTO_ERR_UNKNOWN);
+            break;
+    }
 }
 
 void bleUpdate() {
+    // Requests from the write callback are started here, off the host task
+    if (rxFrameLen) {
+        protoHandle(rxFrame, rxFrameLen);
+        rxFrameLen = 0;
+    }
+    if (ackReceived) {
+        ackReceived = false;
+        syncHandleAck(ackSeq);
+    }
+    if (syncRequested) {
+        syncRequested = false;
+        uint32_t from = syncFromSeq;
+        if (from == SYNC_FROM_PEER) from = peerAckedSeq(connAddr);
+        bleSendWorkoutLog(from);
+    }
+    if (pongRequested && syncTextLen == 0 && syncPendingLen == 0 && !syncPendingNewline) {
+        pongRequested = false;
+        bleSend("PONG\n");
+    }
+
+    // Live data goes ahead of the log so a rep isn't stuck behind a sync
+    livePump();
+    if (liveHandoffNew) {
+        liveHandoffNew = false;
+        uint32_t us = liveHandoffUs;
+        liveHandoffCount++;
+        liveHandoffSumUs += us;
+        if (us > liveHandoffMaxUs) liveHandoffMaxUs = us;
+        Serial.printf("BLE: rep %u live: %lu us to notify, %lu us to stack handoff (avg %lu, max %lu)\n",
+                      liveLastRep, (unsigned long)liveQueueUs, (unsigned long)us,
+                      (unsigned long)(liveHandoffSumUs / liveHandoffCount), (unsigned long)liveHandoffMaxUs);
+    }
+
+    if (syncState != SYNC_IDLE) {
+        syncPump();
+    }
+
+    // Drain whatever is queued, partial frames included
+    txPump(true);
+
+    // Give the stack a moment after a disconnect, without stalling the loop
     if (!deviceConnected && oldDeviceConnected && bleActive) {
-        delay(500);
+        advRestartPending = true;
+        advRestartAtMs = millis() + BLE_ADV_RESTART_MS;
+    }
+    if (advRestartPending && (long)(millis() - advRestartAtMs) >= 0) {
+        advRestartPending = false;
+        advConfigure();
         NimBLEDevice::getAdvertising()->start();
         Serial.println("BLE: Restarted advertising");
     }
 
+    advUpdate();
+
     oldDeviceConnected = deviceConnected;
 }
@@ -3,13 +3,13 @@
 
 #include <Arduino.h>
 
-// Initialize BLE (call once in setup)
+// Bring up the BLE stack (bleStart() does this on first use)
 bool bleInit();
 
-// Start BLE advertising
-void bleStart();
+// Start BLE advertising, initializing the stack if needed
+bool bleStart();
 
-// Stop BLE and free resources
+// Stop BLE and release the stack's memory
 void bleStop();
 
 // Check if BLE is currently active
@@ -18,12 +18,20 @@ bool bleIsActive();
 // Check if a client is connected
 bool bleIsConnected();
 
-// Send data to connected client (returns bytes sent, 0 if not connected)
+// Queue data for the connected client without blocking
+// (returns bytes queued; less than asked when the queue is full, 0 if not connected)
+size_t bleSend(const uint8_t* data, size_t len);
 size_t bleSend(const char* data);
 size_t bleSend(const String& data);
 
-// Send workout log file over BLE
-bool bleSendWorkoutLog();
+// Push out queued data now, including a partially filled frame
+void bleFlush();
+
+// Start sending workout log rows from fromSeq on (streamed from bleUpdate())
+bool bleSendWorkoutLog(uint32_t fromSeq);
+
+// Check if a log sync is still streaming
+bool bleSyncInProgress();
 
 // Process BLE events (call from loop if needed)
 void bleUpdate();
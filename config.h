@@ -30,14 +30,40 @@
 #define AUDIO_MCLK_MULTIPLE (256)
 #define AUDIO_MCLK_FREQ_HZ (AUDIO_SAMPLE_RATE * AUDIO_MCLK_MULTIPLE)
 #define AUDIO_VOLUME (70)
+#define SYNTH_VOICES 4  // Tones that can sound at once
+#define AUDIO_BENCH_SYNTH 0  // Time wavetable vs. sin() synthesis at startup (1 = on)
+#define AUDIO_CUE_QUEUE_LEN 4  // Cues waiting for the audio task
+#define AUDIO_FADE_MS 4  // Fade-out of a cue cut short by a newer one
+#define AUDIO_CUE_CACHE 1  // Play cues pre-rendered at build time (0 = synthesize on the fly)
+#define SONIFY_TONE_MS 60  // Rep tone length
+#define SONIFY_TONE_AMP 18000
+#define AUDIO_STATS_LOG_EVERY 50  // Log latency and trigger stats every N cues/tones played (0 = never)
 
 // ============== DISPLAY SETTINGS ==============
 #define LCD_WIDTH   240
 #define LCD_HEIGHT  284
 #define BRIGHTNESS  255  // Screen brightness: 0-255
 
+// DMA display bus (lcdbus.cpp)
+#define LCD_SPI_HZ          40000000
+#define LCD_DMA_BAND_LINES  10    // Lines per DMA band; two bands of LCD_WIDTH pixels
+#define LCD_DMA_QUEUE_LEN   8     // Rectangles waiting for the flush task (tiles + chart)
+#define LCD_CMD_BUF         64    // Parameter bytes collected per transaction
+
 // ============== UI LAYOUT ==============
 #define DISPLAY_UPDATE_MS 100  // 10 Hz display refresh
+#define DISPLAY_STATS_LOG_EVERY 200  // Log flush stats every N flushes (0 = never)
+#define DISPLAY_BENCH_DIGITS 0  // Time atlas vs. font digits at startup (1 = on)
+#define DISPLAY_FRAME_MS 33  // Render at most this often (~30 fps)
+#define DISPLAY_FRAME_BUDGET_US 8000  // Painting per frame; the rest is deferred
+#ifndef DISPLAY_RAM_BUS  // The host display test builds with 1
+#define DISPLAY_RAM_BUS 0  // Render into RAM instead of the panel (snapshots, byte counts)
+#endif
+#define DISPLAY_SNAPSHOT_DIR "/screens"
+
+// Widget toolkit (ui.cpp)
+#define UI_MAX_WIDGETS   40   // All screens together
+#define UI_HIT_SLOP_MAX  8    // Largest hitSlop of any widget
 
 // Row offset - 0 works for this panel
 #define ROW_OFFSET   0
@@ -72,6 +98,22 @@
 #define VBOX_X      ((LCD_WIDTH - VBOX_WIDTH) / 2)
 #define VBOX_Y      VELOCITY_BOX_Y
 
+// Rep chart (below the velocity box): MCV bars on the left, a sweeping
+// velocity trace on the right
+#define CHART_X         10
+#define CHART_Y         246
+#define CHART_W         220
+#define CHART_H         24
+#define CHART_BARS      16    // Most recent reps shown
+#define CHART_BAR_W     6     // Including a 1 px gap
+#define CHART_TRACE_X   (CHART_X + CHART_BARS * CHART_BAR_W + 8)
+#define CHART_TRACE_W   (CHART_X + CHART_W - CHART_TRACE_X)
+#define CHART_TRACE_MS  50    // One trace column per 50 ms
+#define CHART_MAX_MMS   1500  // Full scale (mm/s)
+#define CHART_PIXEL_BUDGET 480  // Pixels composed per display update
+#define CHART_TOUCH_SLOP 12   // Drags starting this close above/below the bars scroll them
+#define CHART_FLICK_GLIDE_MS 300  // A flick scrolls as far as this long at its speed
+
 // Settings screen layout
 #define SETTINGS_BACK_X      10
 #define SETTINGS_BACK_Y      10
@@ -94,6 +136,7 @@
 #define VELOCITY_THRESHOLD 0.15f // m/s - minimum velocity to detect movement
 #define REP_COMPLETE_THRESHOLD 0.05f // m/s - velocity near zero = rep complete
 #define MIN_REP_TIME_MS 500 // Minimum time between reps (debounce)
+#define REP_TABLE_SIZE  32  // Rep summaries kept for the current set
 #define ACCEL_SCALE 9.81f // m/s² per g
 #define ZERO_CROSS_DEADBAND     0.02f   // m/s: treat |v|<this as zero
 #define PEAK_REQUIRED           0.20f   // m/s: must hit at least this peak each half-cycle
@@ -125,12 +168,38 @@ typedef enum {
 #define SWIPE_MIN_DISTANCE  50 // Minimum pixels to count as swipe
 #define SWIPE_BOTTOM_ZONE   60 // Must start within this many pixels from bottom
 #define SWIPE_TOP_ZONE      60
+// Touch reads
+#define TOUCH_USE_IRQ           1      // Read only when TOUCH_IRQ fires (0 = read every loop)
+#define TOUCH_STALE_MS          100    // Re-read a touch that has gone this long without an IRQ
+#define TOUCH_AUTO_SLEEP_S      2      // Controller dozes after this long untouched (no I2C until touched)
+#define TOUCH_SAMPLE_QUEUE_LEN  8      // Reads waiting for the gesture logic
+#define TOUCH_EVENT_QUEUE_LEN   4      // Gestures waiting for touchUpdate()
+#define TOUCH_STATS_LOG_MS      10000  // Log I2C reads and bus time this often (0 = never)
+#define TOUCH_PROBE_TRIES       10     // Attempts to find the controller at init
+#define TOUCH_PROBE_RETRY_MS    50     // Wait between them
+// Gestures
+#define TOUCH_TRAJ_LEN          16     // Trajectory points kept per touch
+#define TOUCH_VELOCITY_MS       80     // Velocity is taken over this much of the trajectory
+#define TOUCH_DRAG_SLOP         10     // Pixels a touch moves before it is a drag
+#define TOUCH_FLICK_PX_S        600    // Release speed that makes a drag a flick
+#define TOUCH_HOLD_MS           600    // Held still this long starts hold-repeat
+#define TOUCH_REPEAT_MS         120    // Hold-repeat interval
 
 // ============== STORAGE ==============
 #define SD_CS       14    // SD card chip select - VERIFY THIS
 #define SD_MISO     21    // SD card MISO - VERIFY THIS  
 #define LOGFILE "/sessions.csv"
 
+// Session log retention
+#define LOG_SEGMENT_DIR           "/seg"        // Sealed log segments
+#define LOG_SEGMENT_MAX_BYTES     16384         // Roll the active log past this size
+#define LOG_MAX_SEGMENTS          32
+#define LOG_QUOTA_BYTES           (256 * 1024)  // Synced rows are aged out above this
+#define LOG_MIN_FREE_BYTES        (32 * 1024)   // Always keep this much flash free
+#define STORAGE_MAINT_CHUNK       512           // Bytes copied per compaction step
+#define STORAGE_MAINT_INTERVAL_MS 250           // Minimum gap between maintenance steps
+#define STORAGE_CURSOR_BUF        256           // Longest row a log cursor yields whole
+
 // ============== SLEEP SETTINGS ==============
 #define POWER_BUTTON_GPIO 9          // set this to your BOOT GPIO
 #define POWER_BUTTON_ACTIVE_HIGH 1   // press: LOW->HIGH (per your description)
@@ -143,6 +212,43 @@ typedef enum {
 #define BLE_SERVICE_UUID    "6E400001-B5A3-F393-E0A9-E50E24DCCA9E"  // Nordic UART Service
 #define BLE_TX_CHAR_UUID    "6E400003-B5A3-F393-E0A9-E50E24DCCA9E"  // TX (notify)
 #define BLE_RX_CHAR_UUID    "6E400002-B5A3-F393-E0A9-E50E24DCCA9E"  // RX (write)
+#define BLE_LIVE_CHAR_UUID  "6E400004-B5A3-F393-E0A9-E50E24DCCA9E"  // Live telemetry (notify)
+
+// Link tuning for bulk log sync
+#define BLE_PREFERRED_MTU   247   // 244-byte notifications fill one 251-byte DLE packet
+#define BLE_DLE_TX_OCTETS   251   // Data Length Extension: max LL payload
+#define BLE_DEFAULT_PAYLOAD 20    // Notification payload before MTU exchange (23 - 3)
+#define BLE_CONN_ITVL_MIN   6     // 7.5 ms (units of 1.25 ms)
+#define BLE_CONN_ITVL_MAX   12    // 15 ms
+#define BLE_CONN_TIMEOUT    200   // 2 s (units of 10 ms)
+
+// Link outside of a sync: a long interval leaves air time for a hub
+// holding connections to many devices
+#define BLE_IDLE_ITVL_MIN   24    // 30 ms
+#define BLE_IDLE_ITVL_MAX   40    // 50 ms
+#define BLE_IDLE_LATENCY    4     // Connection events the device may skip
+#define BLE_IDLE_TIMEOUT    400   // 4 s
+
+// Advertising (device ID and last-rep summary in manufacturer data)
+#define BLE_COMPANY_ID      0xFFFF  // Bluetooth SIG test ID, no assigned company ID
+#define BLE_ADV_ITVL_MIN    160   // 100 ms (units of 0.625 ms)
+#define BLE_ADV_ITVL_MAX    240   // 150 ms
+#define BLE_ADV_UPDATE_MS   1000  // Fastest refresh of the advertised summary
+#define BLE_ADV_RESTART_MS  500   // Pause before advertising again after a disconnect
+
+// Transmit flow control
+#define BLE_TX_QUEUE_LEN    12    // Pre-packed notification frames (~3 KB)
+#define BLE_TX_MIN_MBUFS    4     // Leave this many msys mbufs for the stack itself
+#define BLE_TX_RETRY_US     2000  // Back-off after the stack reports ENOMEM
+#define BLE_SYNC_FRAMES_PER_UPDATE 4  // Log sync work per loop iteration
+#define BLE_MAX_PEERS       4     // Phones with a remembered sync cursor
+#define BLE_PEERS_FILE      "/peers.dat"
+
+// ============== LIVE TELEMETRY ==============
+#define TELEMETRY_REP_QUEUE      8     // Rep summaries waiting for the radio
+#define TELEMETRY_TRACE_QUEUE    128   // Decimated velocity samples (~2.5 s at 50 Hz)
+#define TELEMETRY_TRACE_HZ       50    // Velocity trace rate
+#define TELEMETRY_TRACE_BATCH_MS 100   // Longest a trace sample waits for a full batch
 
 // ============== BATTERY ==============
 #define BATTERY_UPDATE_INTERVAL 5000  // Update every 5 seconds
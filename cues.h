@@ -0,0 +1,196 @@
+#ifndef _CUES_H_
+#define _CUES_H_
+
+#include <stdint.h>
+#include "config.h"
+#include "sound.h"
+#include "synth.h"
+
+// Sound cues and their pre-rendered cache.
+// A cue is a short list of notes. A note with a harmonic gets a second
+// voice at twice the frequency (a bell-ish hit); gapMs of silence follows.
+// At compile time every cue is played through the synth (synth.h) and
+// encoded as IMA-ADPCM, 4 bits per sample, so playing one is a streaming
+// decode. A new cue is a new note list here.
+
+typedef struct {
+  uint16_t freq;
+  uint16_t ms;
+  int16_t amp;
+  uint8_t attackMs, releaseMs;
+  int16_t harmonic;   // Amplitude of the 2x partial, 0 for none
+  uint8_t gapMs;
+} CueNote;
+
+typedef struct {
+  const CueNote *notes;
+  uint8_t count;
+} Cue;
+
+#define CUE_HARM_ATTACK_MS  6
+#define CUE_HARM_RELEASE_MS 80
+
+namespace cues {
+
+constexpr CueNote kPowerOn[] = {
+  {659, 80, 21000, 8, 60, 2200, 40},      // E5 (major 3rd)
+  {784, 120, 21000, 8, 60, 2200, 0},      // G5 (perfect 5th)
+};
+
+constexpr CueNote kPowerOff[] = {
+  {659, 80, 19000, 8, 60, 1925, 40},      // E5
+  {523, 140, 19000, 8, 60, 1760, 0},      // C5 (longer tail = "settle")
+};
+
+// Quick punchy double-beep: A5 → D6 (fourth interval, higher register)
+constexpr CueNote kStartWorkout[] = {
+  {880, 50, 20000, 4, 10, 0, 25},         // A5 - short, punchy
+  {1175, 80, 21000, 4, 15, 0, 0},         // D6 - slightly longer
+};
+
+// Resolving drop: D6 → A5 (mirror of start)
+constexpr CueNote kStopWorkout[] = {
+  {1175, 60, 19000, 4, 12, 0, 30},        // D6
+  {880, 140, 18000, 4, 40, 0, 0},         // A5 - longer decay = "finished"
+};
+
+#define CUE(notes) {notes, sizeof(notes) / sizeof(notes[0])}
+
+constexpr Cue kCues[SOUND_CUE_COUNT] = {
+  CUE(kPowerOn),
+  CUE(kPowerOff),
+  CUE(kStartWorkout),
+  CUE(kStopWorkout),
+};
+
+#undef CUE
+
+// Start a note's voices
+constexpr void startNote(synth::Bank &b, const CueNote &n) {
+  synth::start(b, n.freq, n.ms, n.amp, n.attackMs, n.releaseMs);
+  if (n.harmonic) synth::start(b, n.freq * 2, n.ms, n.harmonic, CUE_HARM_ATTACK_MS, CUE_HARM_RELEASE_MS);
+}
+
+constexpr uint32_t cueSamples(const Cue &c) {
+  uint32_t n = 0;
+  for (uint8_t i = 0; i < c.count; i++) n += synth::msToSamples(c.notes[i].ms) + synth::msToSamples(c.notes[i].gapMs);
+  return n;
+}
+
+constexpr uint32_t totalBytes() {
+  uint32_t n = 0;
+  for (int i = 0; i < SOUND_CUE_COUNT; i++) n += (cueSamples(kCues[i]) + 1) / 2;
+  return n;
+}
+
+// ---- IMA-ADPCM ----
+
+constexpr int16_t kStep[89] = {
+  7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+  50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+  253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+  1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+  3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+  11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+  32767
+};
+
+constexpr int8_t kIndexShift[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+struct Adpcm {
+  int32_t pred;
+  int8_t index;
+};
+
+// Decode one nibble (the encoder runs the same steps to track the decoder)
+constexpr int16_t decode(Adpcm &st, uint8_t code) {
+  int32_t step = kStep[st.index];
+  int32_t diff = step >> 3;
+  if (code & 4) diff += step;
+  if (code & 2) diff += step >> 1;
+  if (code & 1) diff += step >> 2;
+  st.pred += (code & 8) ? -diff : diff;
+  st.pred = st.pred > 32767 ? 32767 : (st.pred < -32768 ? -32768 : st.pred);
+
+  int index = st.index + kIndexShift[code & 7];
+  st.index = (int8_t)(index < 0 ? 0 : (index > 88 ? 88 : index));
+  return (int16_t)st.pred;
+}
+
+constexpr uint8_t encode(Adpcm &st, int16_t sample) {
+  int32_t step = kStep[st.index];
+  int32_t diff = sample - st.pred;
+  uint8_t code = 0;
+  if (diff < 0) {
+    code = 8;
+    diff = -diff;
+  }
+  if (diff >= step) { code |= 4; diff -= step; }
+  if (diff >= step >> 1) { code |= 2; diff -= step >> 1; }
+  if (diff >= step >> 2) code |= 1;
+  decode(st, code);
+  return code;
+}
+
+constexpr uint32_t kBytes = totalBytes();
+
+struct Cache {
+  uint8_t data[kBytes];                  // Low nibble first; each cue starts at pred 0, index 0
+  uint32_t offset[SOUND_CUE_COUNT];
+  uint32_t samples[SOUND_CUE_COUNT];
+};
+
+// Feed n samples to the encoder, two per byte
+struct Packer {
+  Adpcm st;
+  uint32_t at;
+  bool high;
+};
+
+constexpr void pack(Cache &c, Packer &p, const int16_t *pcm, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++) {
+    uint8_t code = encode(p.st, pcm[i]);
+    if (!p.high) {
+      c.data[p.at] = code;
+    } else {
+      c.data[p.at++] |= code << 4;
+    }
+    p.high = !p.high;
+  }
+}
+
+constexpr Cache build() {
+  Cache c{};
+  uint32_t at = 0;
+
+  for (int k = 0; k < SOUND_CUE_COUNT; k++) {
+    const Cue &cue = kCues[k];
+    c.offset[k] = at;
+    c.samples[k] = cueSamples(cue);
+
+    Packer p{{0, 0}, at, false};
+    synth::Bank bank{};
+    int16_t buf[SYNTH_CHUNK] = {};
+
+    for (uint8_t i = 0; i < cue.count; i++) {
+      startNote(bank, cue.notes[i]);
+      while (synth::active(bank)) {
+        uint32_t n = synth::render(bank, buf, SYNTH_CHUNK);
+        pack(c, p, buf, n);
+      }
+      for (int32_t gap = synth::msToSamples(cue.notes[i].gapMs); gap > 0; gap -= SYNTH_CHUNK) {
+        uint32_t n = gap > SYNTH_CHUNK ? SYNTH_CHUNK : gap;
+        synth::render(bank, buf, n);
+        pack(c, p, buf, n);
+      }
+    }
+    at += (c.samples[k] + 1) / 2;
+  }
+  return c;
+}
+
+}  // namespace cues
+
+static constexpr cues::Cache kCueCache = cues::build();
+
+#endif
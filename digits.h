@@ -0,0 +1,122 @@
+#ifndef _DIGITS_H_
+#define _DIGITS_H_
+
+#include <stdint.h>
+#include "config.h"
+
+// Anti-aliased digit atlas for the value boxes: '0'-'9', '.' and ' '.
+// The glyphs are stroked polylines rendered at compile time with 4x4
+// supersampling and blended straight into RGB565 for the box colors, so
+// drawing a character is one rectangular copy.
+
+#define DIGIT_W      16   // Cell width (the advance of every glyph but '.')
+#define DIGIT_H      24
+#define DIGIT_DOT_W  8    // Advance of '.'
+#define DIGIT_FG     COLOR_CYAN
+#define DIGIT_BG     COLOR_DARKGRAY
+
+#define DIGIT_GLYPHS 12   // 0-9, '.', ' '
+#define DIGIT_DOT    10
+#define DIGIT_SPACE  11
+
+namespace digits {
+
+// Stroke outlines in cell pixels; a negative x lifts the pen
+struct Pt { float x, y; };
+#define UP {-1, 0}
+
+constexpr Pt kStrokes[DIGIT_GLYPHS][24] = {
+  {{5,3},{11,3},{13,5},{13,19},{11,21},{5,21},{3,19},{3,5},{5,3},UP,{12,5},{4,19}},
+  {{5,6},{8,3},{8,21},UP,{5,21},{11,21}},
+  {{3,6},{5,3},{11,3},{13,5},{13,9},{3,21},{13,21}},
+  {{3,5},{5,3},{11,3},{13,5},{13,9},{11,12},{7,12},UP,{11,12},{13,15},{13,19},{11,21},{5,21},{3,19}},
+  {{10,21},{10,3},{3,15},{13,15}},
+  {{13,3},{4,3},{3,11},{11,11},{13,13},{13,19},{11,21},{5,21},{3,19}},
+  {{12,4},{10,3},{6,3},{3,7},{3,19},{5,21},{11,21},{13,19},{13,13},{11,11},{5,11},{3,13}},
+  {{3,3},{13,3},{6,21}},
+  {{5,3},{11,3},{12,5},{12,9},{11,11},{5,11},{4,9},{4,5},{5,3},UP,
+   {5,11},{11,11},{13,13},{13,19},{11,21},{5,21},{3,19},{3,13},{5,11}},
+  {{4,20},{6,21},{10,21},{13,17},{13,5},{11,3},{5,3},{3,5},{3,11},{5,13},{11,13},{13,11}},
+  {{3.5f,19.5f},{4.5f,20.5f}},
+  {},
+};
+constexpr uint8_t kPoints[DIGIT_GLYPHS] = {12, 6, 7, 14, 4, 9, 12, 3, 19, 12, 2, 0};
+
+#undef UP
+
+constexpr float kRadius = 1.6f;   // Half the stroke width
+
+// Squared distance from p to segment ab
+constexpr float segDist2(float px, float py, Pt a, Pt b) {
+  float dx = b.x - a.x, dy = b.y - a.y;
+  float len2 = dx * dx + dy * dy;
+  float t = len2 > 0 ? ((px - a.x) * dx + (py - a.y) * dy) / len2 : 0;
+  t = t < 0 ? 0 : (t > 1 ? 1 : t);
+  float ex = a.x + t * dx - px, ey = a.y + t * dy - py;
+  return ex * ex + ey * ey;
+}
+
+constexpr bool covered(int g, float px, float py) {
+  for (int i = 1; i < kPoints[g]; i++) {
+    Pt a = kStrokes[g][i - 1], b = kStrokes[g][i];
+    if (a.x < 0 || b.x < 0) continue;
+    if (segDist2(px, py, a, b) <= kRadius * kRadius) return true;
+  }
+  return false;
+}
+
+// Coverage (0-16) of the pixel whose top-left corner is x, y
+constexpr int coverage(int g, int x, int y) {
+  // Most pixels are well clear of every stroke
+  float near = kRadius + 0.75f;
+  bool any = false;
+  for (int i = 1; i < kPoints[g] && !any; i++) {
+    Pt a = kStrokes[g][i - 1], b = kStrokes[g][i];
+    if (a.x >= 0 && b.x >= 0 && segDist2(x + 0.5f, y + 0.5f, a, b) <= near * near) any = true;
+  }
+  if (!any) return 0;
+
+  int n = 0;
+  for (int sy = 0; sy < 4; sy++) {
+    for (int sx = 0; sx < 4; sx++) {
+      if (covered(g, x + (sx + 0.5f) / 4, y + (sy + 0.5f) / 4)) n++;
+    }
+  }
+  return n;
+}
+
+constexpr uint16_t blend(uint16_t fg, uint16_t bg, int a16) {
+  int r = ((fg >> 11) * a16 + (bg >> 11) * (16 - a16) + 8) / 16;
+  int g = (((fg >> 5) & 0x3F) * a16 + ((bg >> 5) & 0x3F) * (16 - a16) + 8) / 16;
+  int b = ((fg & 0x1F) * a16 + (bg & 0x1F) * (16 - a16) + 8) / 16;
+  return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+struct Atlas {
+  uint16_t px[DIGIT_GLYPHS][DIGIT_H][DIGIT_W];
+};
+
+constexpr Atlas build(uint16_t fg, uint16_t bg) {
+  Atlas a{};
+  for (int g = 0; g < DIGIT_GLYPHS; g++) {
+    for (int y = 0; y < DIGIT_H; y++) {
+      for (int x = 0; x < DIGIT_W; x++) a.px[g][y][x] = blend(fg, bg, coverage(g, x, y));
+    }
+  }
+  return a;
+}
+
+}  // namespace digits
+
+// Native-endian RGB565, row-major, DIGIT_W pixels per row
+static constexpr digits::Atlas kDigitAtlas = digits::build(DIGIT_FG, DIGIT_BG);
+
+// Atlas index of c, or -1 if there is no glyph for it
+static inline int digitGlyph(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c == '.') return DIGIT_DOT;
+  if (c == ' ') return DIGIT_SPACE;
+  return -1;
+}
+
+#endif
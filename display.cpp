@@ -1,27 +1,249 @@
 #include "display.h"
-#include "slider.h"
+#include "lcdram.h"
+#include "ui.h"
 #include "workout.h"
 #include "config.h"
-#include "image.h"
+#include "splash.h"
+#include "digits.h"
 #include "sound.h"
 #include "rtc.h"
 
 // Display hardware objects
-static Arduino_DataBus *bus = nullptr;
+#if DISPLAY_RAM_BUS
+#include <LittleFS.h>
+typedef LcdRamBus DisplayBus;
+#else
+#include "lcdbus.h"
+typedef LcdDmaBus DisplayBus;
+#endif
+static DisplayBus *bus = nullptr;
 static Arduino_GFX *gfx = nullptr;
 static bool isOn = true;
 static uint brightness = BRIGHTNESS;
 
-static Slider brightnessSlider;
-static Slider sensitivitySlider;
-static Slider volumeSlider;
+// ============== Off-screen tiles ==============
+// Readouts are drawn into small canvases and compared with what the panel
+// already shows. Only the bounding box of the changed pixels is sent, in a
+// single address window, and nothing is cleared on the panel first, so the
+// digits no longer flicker. The transfer is queued for DMA; a tile is only
+// redrawn once its previous flush is out.
+
+#define WINDOW_CMD_BYTES 11   // CASET + RASET + RAMWR with their parameters
+
+typedef struct {
+    int16_t x, y, w, h;        // Panel position
+    Arduino_Canvas *canvas;    // Next content
+    uint16_t *shown;           // Content on the panel
+    bool valid;                // shown matches the panel
+    volatile bool sent;        // Last flush finished, canvas may be redrawn
+} DisplayTile;
+
+static DisplayTile repsTile;
+static DisplayTile timeTile;
+static DisplayTile peakTile;
+static DisplayTile batteryTile;
+static DisplayStats stats;
+
+// ============== Rep chart ==============
+// Bars and trace columns are composed into chartBuf and queued as a few
+// rectangles per update; nothing already on screen is repainted, except
+// that all bars move left once there are more reps than slots.
+
+#define CHART_PENDING 32                   // Trace columns waiting to be drawn
+#define CHART_MID     (CHART_H / 2)        // Trace zero line (row)
+#define CHART_BLANK   INT8_MIN             // Cursor gap column
+
+static_assert(CHART_BARS <= 32, "bar dirty flags are a uint32_t");
+static_assert(CHART_PIXEL_BUDGET >= CHART_BAR_W * CHART_H, "budget must fit one bar");
+
+typedef struct {
+    bool shown;                  // Main screen is up
+    bool paused;                 // Calibration message covers the chart
+    int firstRep;                // Rep in the leftmost bar slot
+    bool scrolledBack;           // Showing older reps; new ones do not shift the bars
+    int repsShown;               // Last rep handed to the bars
+    uint32_t dirtyBars;          // Slots to redraw
+    uint16_t bestMmS;            // Fastest rep mean of the set
+
+    int8_t pending[CHART_PENDING];
+    uint8_t pendHead, pendTail;  // Ring of trace columns (pixels from the zero line)
+    uint16_t cursor;             // Next trace column
+    uint32_t dropped;
+
+    uint32_t binStartMs;         // Sample binning
+    float binSum;
+    uint16_t binCount;
+} ChartState;
+
+static ChartState chart;
+static uint16_t chartBuf[CHART_PIXEL_BUDGET];
+static volatile bool chartSent = true;   // Last rectangle of the previous update is out
+
+// Render scheduler jobs (bits of jobsPending)
+#define JOB_REPS     0x01
+#define JOB_TIME     0x02
+#define JOB_PEAK     0x04
+#define JOB_BATTERY  0x08
+#define JOB_CHART    0x10
+
+static uint8_t jobsPending = 0;
+static unsigned long lastFrameMs = 0;
+
+// CPU time spent in display updates, per second
+static unsigned long cpuWindowStartMs = 0;
+static uint32_t cpuWindowUs = 0;
+
+// Last values shown by the readouts, redrawn when their box is repainted
+static int shownReps = 0;
+static int shownTime = 0;
+static float shownPeak = 0.0f;
+static int shownBattery = 0;
+
+// Screens (built once in displayInit)
+static UiWidget *mainScreen = nullptr;
+static UiWidget *startButton, *repsBox, *timeBox, *velocityBox, *chartWidget, *swipeBar;
+static bool startButtonPressed = false;
+
+static UiWidget *settingsScreen = nullptr;
+static UiWidget *brightnessSlider, *sensitivitySlider, *volumeSlider, *bleButton, *toneButton;
+
+static UiWidget *pickerScreen = nullptr;
+static UiWidget *pickerRows[5];
 
 // BLE state
 static bool bleEnabled = false;
 
+static bool tileInit(DisplayTile *t, int16_t x, int16_t y, int16_t w, int16_t h) {
+    t->x = x;
+    t->y = y;
+    t->w = w;
+    t->h = h;
+    t->valid = false;
+    t->sent = true;
+    t->canvas = new Arduino_Canvas(w, h, gfx, x, y);
+    t->shown = (uint16_t *)malloc((size_t)w * h * sizeof(uint16_t));
+    return t->shown && t->canvas->begin(GFX_SKIP_OUTPUT_BEGIN);
+}
+
+// The panel under the tile was just painted with one color
+static void tileAssume(DisplayTile *t, uint16_t color) {
+    for (int32_t i = 0; i < (int32_t)t->w * t->h; i++) t->shown[i] = color;
+    t->valid = true;
+}
+
+static void tilesInvalidate() {
+    repsTile.valid = false;
+    timeTile.valid = false;
+    peakTile.valid = false;
+    batteryTile.valid = false;
+    chart.shown = false;
+}
+
+// Wait for the tile's last transfer before drawing into it again
+static Arduino_Canvas *tileBegin(DisplayTile *t) {
+    while (!t->sent) vTaskDelay(1);
+    return t->canvas;
+}
+
+static void statsAddCpu(unsigned long startUs) {
+    uint32_t us = micros() - startUs;
+    stats.lastUs = us;
+    if (us > stats.maxUs) stats.maxUs = us;
+    cpuWindowUs += us;
+
+    unsigned long now = millis();
+    if (now - cpuWindowStartMs >= 1000) {
+        stats.cpuUsPerSec = cpuWindowUs * 1000UL / (now - cpuWindowStartMs);
+        if (workoutIsSetActive()) {
+            Serial.printf("Display: %lu us/s CPU in updates, %lu frames (last %lu us, max %lu), %lu over budget, %lu deferred\n",
+                          (unsigned long)stats.cpuUsPerSec, (unsigned long)stats.frames,
+                          (unsigned long)stats.frameUs, (unsigned long)stats.frameMaxUs,
+                          (unsigned long)stats.framesOver, (unsigned long)stats.deferred);
+        }
+        cpuWindowStartMs = now;
+        cpuWindowUs = 0;
+    }
+}
+
+// Queue the bounding box of what changed since the last flush. Returns
+// false if the bus queue was full; the tile is then left as it was shown,
+// so the next flush sends the change.
+static bool tileFlush(DisplayTile *t, unsigned long startUs) {
+    const uint16_t *fb = t->canvas->getFramebuffer();
+    int16_t x0 = t->w, x1 = -1, y0 = -1, y1 = -1;
+
+    for (int16_t y = 0; y < t->h; y++) {
+        const uint16_t *a = fb + y * t->w;
+        const uint16_t *b = t->shown + y * t->w;
+        if (t->valid && memcmp(a, b, t->w * sizeof(uint16_t)) == 0) continue;
+
+        int16_t l = 0, r = t->w - 1;
+        if (t->valid) {
+            while (a[l] == b[l]) l++;
+            while (a[r] == b[r]) r--;
+        }
+        if (y0 < 0) y0 = y;
+        y1 = y;
+        if (l < x0) x0 = l;
+        if (r > x1) x1 = r;
+    }
+
+    if (y0 < 0) {
+        stats.skipped++;
+        statsAddCpu(startUs);
+        return true;
+    }
+
+    uint16_t w = x1 - x0 + 1;
+    uint16_t h = y1 - y0 + 1;
+    if (!bus->queueRect(t->x + x0, t->y + y0 + ROW_OFFSET, w, h, fb + y0 * t->w + x0, t->w,
+                        false, &t->sent)) {
+        statsAddCpu(startUs);
+        return false;
+    }
+
+    memcpy(t->shown + y0 * t->w, fb + y0 * t->w, (size_t)h * t->w * sizeof(uint16_t));
+    t->valid = true;
+
+    stats.flushes++;
+    stats.lastBytes = (uint32_t)w * h * 2 + WINDOW_CMD_BYTES;
+    stats.spiBytes += stats.lastBytes;
+    statsAddCpu(startUs);
+
+#if DISPLAY_STATS_LOG_EVERY > 0
+    if (stats.flushes % DISPLAY_STATS_LOG_EVERY == 0) {
+        Serial.printf("Display: %lu flushes (%lu skipped), avg %lu bytes, last %lu us, max %lu us\n",
+                      (unsigned long)stats.flushes, (unsigned long)stats.skipped,
+                      (unsigned long)(stats.spiBytes / stats.flushes),
+                      (unsigned long)stats.lastUs, (unsigned long)stats.maxUs);
+    }
+#endif
+    return true;
+}
+
+#if DISPLAY_BENCH_DIGITS
+static void benchDigits();
+#endif
+static void buildMainScreen();
+static void buildSettingsScreen();
+static void buildPickerScreen();
+static bool drawBatteryIcon(int percent);
+static void snapshotScreen(const char *name);
+
+void displayGetStats(DisplayStats *out) {
+    *out = stats;
+    out->busPixels = bus ? bus->pixelsSent() : 0;
+    out->busBytes = bus ? bus->bytesSent() : 0;
+}
+
 void displayInit() {
-    // Use Arduino_HWSPI for ESP32-C6
-    bus = new Arduino_HWSPI(LCD_DC, LCD_CS, LCD_SCK, LCD_DIN);
+#if DISPLAY_RAM_BUS
+    // Panel memory in RAM; nothing is sent (see lcdram.h)
+    bus = new LcdRamBus(240, 320);
+#else
+    // spi_master with DMA; pixel transfers run in the background
+    bus = new LcdDmaBus(LCD_DC, LCD_CS, LCD_SCK, LCD_DIN);
+#endif
     
     // First, create a full 320-height display to clear the entire buffer
     Arduino_GFX *gfx_full = new Arduino_ST7789(
@@ -63,6 +285,23 @@ void displayInit() {
     );
     
     gfx->begin();
+
+    // Readout tiles (inside the value boxes, clear of their rounded corners)
+    if (!tileInit(&repsTile, BOX_LEFT_X + 10, BOX_Y + 22, BOX_WIDTH - 20, 28) ||
+        !tileInit(&timeTile, BOX_RIGHT_X + 10, BOX_Y + 22, BOX_WIDTH - 20, 28) ||
+        !tileInit(&peakTile, VBOX_X + 20, VBOX_Y + 22, VBOX_WIDTH - 40, 24) ||
+        !tileInit(&batteryTile, 25, 6, 31, 14)) {
+        Serial.println("Display tile allocation failed!");
+        while (1) delay(1000);
+    }
+
+#if DISPLAY_BENCH_DIGITS
+    benchDigits();
+#endif
+
+    buildMainScreen();
+    buildSettingsScreen();
+    buildPickerScreen();
     
     // Setup backlight
     pinMode(GFX_BL, OUTPUT);
@@ -121,7 +360,7 @@ bool displayIsOn() {
     return isOn;
 }
 
-void displayError(const char *text) {
+static void drawError(const char *text) {
     gfx->fillScreen(COLOR_BLACK);
     gfx->setTextColor(COLOR_RED, COLOR_BLACK);
 
@@ -148,127 +387,609 @@ void displayError(const char *text) {
     gfx->print(text);
 }
 
+void displayError(const char *text) {
+    tilesInvalidate();
+    uiShow(nullptr);
+    drawError(text);
+    snapshotScreen("error");
+}
+
 void displaySplashScreen() {
-  // Draw the Lyft logo image (240x280) for 3 seconds
-  gfx->draw16bitBeRGBBitmap(0, 0, (uint16_t *)gImage_image, 240, 280);
+  // Draw the Lyft logo image (240x280) from its runs: long ones become
+  // fills, short ones are expanded into a row buffer and sent as pixels
+  unsigned long startUs = micros();
+  uint16_t row[SPLASH_W];
+  uint16_t rowLen = 0;
+
+  tilesInvalidate();
+  uiShow(nullptr);
+  bus->beginWrite();
+  bus->writeWindow(0, ROW_OFFSET, SPLASH_W, SPLASH_H);
+  for (uint32_t i = 0; i < SPLASH_RUNS; i++) {
+    uint16_t color = kSplash.palette[kSplash.runs[i] >> 14];
+    uint32_t len = (kSplash.runs[i] & (SPLASH_RUN_MAX - 1)) + 1;
+
+    if (len >= SPLASH_FILL_MIN) {
+      if (rowLen) bus->writePixels(row, rowLen);
+      rowLen = 0;
+      bus->writeRepeat(color, len);
+      continue;
+    }
+    while (len--) {
+      row[rowLen++] = color;
+      if (rowLen == SPLASH_W) {
+        bus->writePixels(row, rowLen);
+        rowLen = 0;
+      }
+    }
+  }
+  if (rowLen) bus->writePixels(row, rowLen);
+  bus->endWrite();
+
+  Serial.printf("Splash: %u runs drawn in %lu us\n", (unsigned)SPLASH_RUNS, micros() - startUs);
 }
 
 void displayDrawButton(bool isRunning) {
-    uint16_t btnColor = isRunning ? COLOR_RED : COLOR_GREEN;
-    const char *btnText = isRunning ? "STOP" : "START";
+    startButton->text = isRunning ? "STOP" : "START";
+    startButton->color = isRunning ? COLOR_RED : COLOR_GREEN;
+    startButton->textColor = isRunning ? COLOR_WHITE : COLOR_BLACK;
+    uiInvalidate(startButton, UI_DIRTY_FULL);
+}
 
-    gfx->fillRoundRect(BTN_X, BTN_Y, BTN_WIDTH, BTN_HEIGHT, BTN_RADIUS, btnColor);
-    gfx->drawRoundRect(BTN_X, BTN_Y, BTN_WIDTH, BTN_HEIGHT, BTN_RADIUS, COLOR_LIGHTGRAY);
+// Box frame and centered title
+static void paintBox(UiWidget *w) {
+    gfx->fillRoundRect(w->x, w->y, w->w, w->h, BOX_RADIUS, COLOR_DARKGRAY);
+    gfx->drawRoundRect(w->x, w->y, w->w, w->h, BOX_RADIUS, COLOR_LIGHTGRAY);
+    gfx->setTextSize(1);
+    gfx->setTextColor(COLOR_WHITE);
+    gfx->setCursor(w->x + (w->w - (int16_t)strlen(w->text) * 6) / 2, w->y + 6);
+    gfx->print(w->text);
+}
 
-    if (isRunning) {
-        gfx->setTextColor(COLOR_WHITE);
-    } else {
-        gfx->setTextColor(COLOR_BLACK);
-    }
-    gfx->setTextSize(2);
+// The box fill covered the readout, so only the digits need sending
+static void drawRepsBox(UiWidget *w, uint8_t dirty) {
+    paintBox(w);
+    tileAssume(&repsTile, COLOR_DARKGRAY);
+    jobsPending |= JOB_REPS;
+}
 
-    int16_t textWidth = strlen(btnText) * 12;
-    int16_t textX = BTN_X + (BTN_WIDTH - textWidth) / 2;
-    int16_t textY = BTN_Y + (BTN_HEIGHT - 16) / 2;
+static void drawTimeBox(UiWidget *w, uint8_t dirty) {
+    paintBox(w);
+    tileAssume(&timeTile, COLOR_DARKGRAY);
+    jobsPending |= JOB_TIME;
+}
 
-    gfx->setCursor(textX, textY);
-    gfx->print(btnText);
+static void drawVelocityBox(UiWidget *w, uint8_t dirty) {
+    paintBox(w);
+    tileAssume(&peakTile, COLOR_DARKGRAY);
+    jobsPending |= JOB_PEAK;
 }
 
 void displayDrawValueBoxes() {
-    // Left box (Reps)
-    gfx->fillRoundRect(BOX_LEFT_X, BOX_Y, BOX_WIDTH, BOX_HEIGHT, BOX_RADIUS, COLOR_DARKGRAY);
-    gfx->drawRoundRect(BOX_LEFT_X, BOX_Y, BOX_WIDTH, BOX_HEIGHT, BOX_RADIUS, COLOR_LIGHTGRAY);
+    uiInvalidate(repsBox, UI_DIRTY_FULL);
+    uiInvalidate(timeBox, UI_DIRTY_FULL);
+}
 
-    // Right box (Time)
-    gfx->fillRoundRect(BOX_RIGHT_X, BOX_Y, BOX_WIDTH, BOX_HEIGHT, BOX_RADIUS, COLOR_DARKGRAY);
-    gfx->drawRoundRect(BOX_RIGHT_X, BOX_Y, BOX_WIDTH, BOX_HEIGHT, BOX_RADIUS, COLOR_LIGHTGRAY);
+void displayDrawVelocityBox() {
+    uiInvalidate(velocityBox, UI_DIRTY_FULL);
+}
 
-    // Labels
-    gfx->setTextSize(1);
+// Width of str in atlas glyphs
+static int16_t digitsWidth(const char *str) {
+    int16_t w = 0;
+    for (; *str; str++) w += (*str == '.') ? DIGIT_DOT_W : DIGIT_W;
+    return w;
+}
 
-    gfx->setTextColor(COLOR_WHITE);
-    gfx->setCursor(BOX_LEFT_X + 36, BOX_Y + 6);
-    gfx->print("REPS");
+// Copy atlas glyphs into the tile's canvas, one rectangle per character.
+// The glyphs are pre-blended onto the box color.
+static void drawDigits(DisplayTile *t, int16_t x, int16_t y, const char *str) {
+    uint16_t *fb = t->canvas->getFramebuffer();
+
+    for (; *str; str++) {
+        int g = digitGlyph(*str);
+        int16_t w = (*str == '.') ? DIGIT_DOT_W : DIGIT_W;
+        if (g < 0 || x < 0 || y < 0 || x + w > t->w || y + DIGIT_H > t->h) {
+            x += w;
+            continue;
+        }
+        for (int16_t row = 0; row < DIGIT_H; row++) {
+            memcpy(fb + (y + row) * t->w + x, kDigitAtlas.px[g][row], w * sizeof(uint16_t));
+        }
+        x += w;
+    }
+}
 
-    gfx->setTextColor(COLOR_WHITE);
-    gfx->setCursor(BOX_RIGHT_X + 28, BOX_Y + 6);
-    gfx->print("TIME(s)");
+// Three-digit counter, centered in its value box
+static bool drawCounter(DisplayTile *t, int value) {
+    unsigned long startUs = micros();
+    Arduino_Canvas *c = tileBegin(t);
+
+    char buf[8];
+    sprintf(buf, "%3d", constrain(value, 0, 999));
+    c->fillScreen(COLOR_DARKGRAY);
+    drawDigits(t, (t->w - digitsWidth(buf)) / 2, (t->h - DIGIT_H) / 2, buf);
 
-    displayUpdateReps(0);
-    displayUpdateTime(0);
+    return tileFlush(t, startUs);
 }
 
-void displayDrawVelocityBox() {
-    gfx->fillRoundRect(VBOX_X, VBOX_Y, VBOX_WIDTH, VBOX_HEIGHT, BOX_RADIUS, COLOR_DARKGRAY);
-    gfx->drawRoundRect(VBOX_X, VBOX_Y, VBOX_WIDTH, VBOX_HEIGHT, BOX_RADIUS, COLOR_LIGHTGRAY);
+#if DISPLAY_BENCH_DIGITS
+// Render a counter into the reps canvas with the scaled 5x7 font and with
+// the atlas (no transfer, so only the drawing cost is compared)
+static void benchDigits() {
+    const int runs = 200;
+    Arduino_Canvas *c = repsTile.canvas;
+    char buf[8];
 
-    gfx->setTextSize(1);
-    gfx->setTextColor(COLOR_WHITE);
-    gfx->setCursor(VBOX_X + 70, VBOX_Y + 6);
-    gfx->print("PEAK VEL (m/s)");
+    unsigned long startUs = micros();
+    for (int i = 0; i < runs; i++) {
+        sprintf(buf, "%3d", i % 1000);
+        c->fillScreen(COLOR_DARKGRAY);
+        c->setTextSize(3);
+        c->setTextColor(COLOR_CYAN);
+        c->setCursor((BOX_WIDTH - 54) / 2 - 10, 3);
+        c->print(buf);
+    }
+    unsigned long fontUs = micros() - startUs;
+
+    startUs = micros();
+    for (int i = 0; i < runs; i++) {
+        sprintf(buf, "%3d", i % 1000);
+        c->fillScreen(COLOR_DARKGRAY);
+        drawDigits(&repsTile, (repsTile.w - digitsWidth(buf)) / 2, (repsTile.h - DIGIT_H) / 2, buf);
+    }
+    unsigned long atlasUs = micros() - startUs;
 
-    displayUpdatePeakVelocity(0.0);
+    repsTile.valid = false;
+    Serial.printf("Digits: font %lu us, atlas %lu us per counter (%d runs)\n",
+                  fontUs / runs, atlasUs / runs, runs);
 }
+#endif
 
 void displayUpdateReps(int value) {
-    gfx->fillRect(BOX_LEFT_X + 10, BOX_Y + 22, BOX_WIDTH - 20, 28, COLOR_DARKGRAY);
-    gfx->setTextSize(3);
-    gfx->setTextColor(COLOR_CYAN);
-
-    char buf[8];
-    sprintf(buf, "%3d", constrain(value, 0, 999));
-    gfx->setCursor(BOX_LEFT_X + (BOX_WIDTH - 54) / 2, BOX_Y + 25);
-    gfx->print(buf);
+    shownReps = value;
+    jobsPending |= JOB_REPS;
 }
 
 void displayUpdateTime(int value) {
-    gfx->fillRect(BOX_RIGHT_X + 10, BOX_Y + 22, BOX_WIDTH - 20, 28, COLOR_DARKGRAY);
-    gfx->setTextSize(3);
-    gfx->setTextColor(COLOR_CYAN);
-
-    char buf[8];
-    sprintf(buf, "%3d", constrain(value, 0, 999));
-    gfx->setCursor(BOX_RIGHT_X + (BOX_WIDTH - 54) / 2, BOX_Y + 25);
-    gfx->print(buf);
+    shownTime = value;
+    jobsPending |= JOB_TIME;
 }
 
 void displayUpdatePeakVelocity(float value) {
-    gfx->fillRect(VBOX_X + 20, VBOX_Y + 22, VBOX_WIDTH - 40, 24, COLOR_DARKGRAY);
-    gfx->setTextSize(3);
-    gfx->setTextColor(COLOR_CYAN);
+    shownPeak = value;
+    jobsPending |= JOB_PEAK;
+}
+
+static bool drawPeak(float value) {
+    unsigned long startUs = micros();
+    Arduino_Canvas *c = tileBegin(&peakTile);
 
     char buf[8];
-    sprintf(buf, "%.2f", value);
-    int16_t textWidth = strlen(buf) * 18;
-    gfx->setCursor(VBOX_X + (VBOX_WIDTH - textWidth) / 2, VBOX_Y + 22);
-    gfx->print(buf);
+    snprintf(buf, sizeof(buf), "%.2f", value);
+    c->fillScreen(COLOR_DARKGRAY);
+    drawDigits(&peakTile, (peakTile.w - digitsWidth(buf)) / 2, 0, buf);
+
+    return tileFlush(&peakTile, startUs);
+}
+
+// Clear the chart area and schedule every bar; the trace restarts at the left
+static void chartRedraw() {
+    gfx->fillRect(CHART_X, CHART_Y, CHART_W, CHART_H, COLOR_BLACK);
+    gfx->drawFastHLine(CHART_TRACE_X, CHART_Y + CHART_MID, CHART_TRACE_W, COLOR_DARKGRAY);
+    chart.dirtyBars = 0xFFFFFFFFu >> (32 - CHART_BARS);
+    chart.cursor = 0;
+    chart.pendTail = chart.pendHead;
+    chart.shown = true;
+}
+
+static void drawChart(UiWidget *w, uint8_t dirty) {
+    // Repainted once the calibration message is gone
+    if (!chart.paused) chartRedraw();
+}
+
+void displayResetChart() {
+    chart.firstRep = 1;
+    chart.scrolledBack = false;
+    chart.repsShown = 0;
+    chart.bestMmS = 0;
+    chart.binCount = 0;
+    chart.binSum = 0.0f;
+    uiInvalidate(chartWidget, UI_DIRTY_FULL);
+}
+
+void displayChartAddSample(float velocity, uint32_t nowMs) {
+    if (chart.binCount == 0) chart.binStartMs = nowMs;
+    chart.binSum += velocity;
+    chart.binCount++;
+    if (nowMs - chart.binStartMs < CHART_TRACE_MS) return;
+
+    int32_t mmS = (int32_t)(chart.binSum / chart.binCount * 1000.0f);
+    chart.binSum = 0.0f;
+    chart.binCount = 0;
+
+    // Oldest columns go first if drawing falls behind
+    if ((uint8_t)(chart.pendHead - chart.pendTail) >= CHART_PENDING) {
+        chart.pendTail++;
+        chart.dropped++;
+    }
+    int32_t px = mmS * (CHART_MID - 1) / CHART_MAX_MMS;
+    chart.pending[chart.pendHead % CHART_PENDING] = (int8_t)constrain(px, -(CHART_MID - 1), CHART_MID - 1);
+    chart.pendHead++;
+}
+
+// One bar slot (bar plus gap column) into buf, stride CHART_BAR_W
+static void chartComposeBar(uint16_t *buf, const RepSummary *r) {
+    int16_t h = 0;
+    uint16_t color = COLOR_GREEN;
+
+    if (r) {
+        h = constrain((int32_t)r->meanMmS * CHART_H / CHART_MAX_MMS, 1, CHART_H);
+        // Velocity loss against the fastest rep so far
+        if (r->meanMmS * 10 < chart.bestMmS * 8) color = COLOR_RED;
+        else if (r->meanMmS * 10 < chart.bestMmS * 9) color = COLOR_YELLOW;
+    }
+    for (int16_t y = 0; y < CHART_H; y++) {
+        uint16_t c = (y >= CHART_H - h) ? color : COLOR_BLACK;
+        for (int16_t x = 0; x < CHART_BAR_W - 1; x++) buf[y * CHART_BAR_W + x] = c;
+        buf[y * CHART_BAR_W + CHART_BAR_W - 1] = COLOR_BLACK;
+    }
+}
+
+// One trace column into buf at column x of a rectangle stride pixels wide
+static void chartComposeColumn(uint16_t *buf, uint16_t stride, uint16_t x, int8_t v) {
+    for (int16_t y = 0; y < CHART_H; y++) {
+        uint16_t c = (y == CHART_MID) ? COLOR_DARKGRAY : COLOR_BLACK;
+        if (v == CHART_BLANK) c = COLOR_BLACK;
+        else if (v > 0 && y < CHART_MID && y >= CHART_MID - v) c = COLOR_CYAN;
+        else if (v < 0 && y >= CHART_MID && y < CHART_MID - v) c = COLOR_CYAN;
+        buf[y * stride + x] = c;
+    }
+}
+
+void displayUpdateChart() {
+    jobsPending |= JOB_CHART;
+}
+
+static void chartRender() {
+    if (!chart.shown || chart.paused) return;
+    // Never wait for the bus here; whatever is left goes out next time
+    if (!chartSent) return;
+
+    unsigned long startUs = micros();
+    uint16_t used = 0;
+    int16_t lastX = -1, lastW = 0;
+    uint16_t *lastBuf = nullptr;
+
+    // Compose no more rectangles than the bus queue takes now, so none of
+    // the queueRect() calls below can fail; the rest stays dirty
+    uint8_t slots = bus->queueSpace();
+
+    // New reps: append a bar, or shift every bar left once the slots are full
+    int reps = workoutGetReps();
+    while (chart.repsShown < reps) {
+        chart.repsShown++;
+        const RepSummary *r = workoutGetRep(chart.repsShown);
+        if (r && r->meanMmS > chart.bestMmS) chart.bestMmS = r->meanMmS;
+        if (chart.repsShown - chart.firstRep >= CHART_BARS) {
+            if (chart.scrolledBack) continue;
+            chart.firstRep = chart.repsShown - CHART_BARS + 1;
+            chart.dirtyBars = 0xFFFFFFFFu >> (32 - CHART_BARS);
+        } else {
+            chart.dirtyBars |= 1u << (chart.repsShown - chart.firstRep);
+        }
+    }
+
+    for (uint8_t i = 0; i < CHART_BARS && chart.dirtyBars; i++) {
+        if (!(chart.dirtyBars & (1u << i))) continue;
+        if (used + CHART_BAR_W * CHART_H > CHART_PIXEL_BUDGET || !slots) break;
+        slots--;
+
+        uint16_t *buf = chartBuf + used;
+        chartComposeBar(buf, workoutGetRep(chart.firstRep + i));
+        if (lastBuf) bus->queueRect(lastX, CHART_Y + ROW_OFFSET, lastW, CHART_H, lastBuf, lastW, false, nullptr);
+        lastX = CHART_X + i * CHART_BAR_W;
+        lastW = CHART_BAR_W;
+        lastBuf = buf;
+        used += CHART_BAR_W * CHART_H;
+        chart.dirtyBars &= ~(1u << i);
+    }
+
+    // Pending trace columns, followed by a blank column at the cursor; one
+    // rectangle per run up to the right edge
+    while (chart.pendTail != chart.pendHead) {
+        uint16_t room = (CHART_PIXEL_BUDGET - used) / CHART_H;
+        uint16_t avail = (uint8_t)(chart.pendHead - chart.pendTail);
+        uint16_t n = min(avail, (uint16_t)(CHART_TRACE_W - chart.cursor));
+        if (n + 1 > room) n = room > 1 ? room - 1 : 0;
+        if (n == 0 || !slots) break;
+        slots--;
+
+        uint16_t w = (chart.cursor + n < CHART_TRACE_W) ? n + 1 : n;
+        uint16_t *buf = chartBuf + used;
+        for (uint16_t k = 0; k < n; k++) {
+            chartComposeColumn(buf, w, k, chart.pending[chart.pendTail % CHART_PENDING]);
+            chart.pendTail++;
+        }
+        if (w > n) chartComposeColumn(buf, w, n, CHART_BLANK);
+
+        if (lastBuf) bus->queueRect(lastX, CHART_Y + ROW_OFFSET, lastW, CHART_H, lastBuf, lastW, false, nullptr);
+        lastX = CHART_TRACE_X + chart.cursor;
+        lastW = w;
+        lastBuf = buf;
+        used += w * CHART_H;
+        chart.cursor = (chart.cursor + n) % CHART_TRACE_W;
+    }
+
+    // The last rectangle carries the completion flag; the flush task works in order
+    if (lastBuf) {
+        bus->queueRect(lastX, CHART_Y + ROW_OFFSET, lastW, CHART_H, lastBuf, lastW, false, &chartSent);
+        stats.spiBytes += (uint32_t)used * 2;
+    }
+    statsAddCpu(startUs);
+}
+
+// Move the bars n reps (negative = older), as far as the rep table goes.
+// Back at the newest rep, new reps shift the bars again.
+static bool chartScroll(int n) {
+    int newest = max(1, chart.repsShown - CHART_BARS + 1);
+    int oldest = max(1, chart.repsShown - REP_TABLE_SIZE + 1);
+    int first = constrain(chart.firstRep + n, oldest, newest);
+    if (first == chart.firstRep) return false;
+
+    chart.firstRep = first;
+    chart.scrolledBack = first < newest;
+    chart.dirtyBars = 0xFFFFFFFFu >> (32 - CHART_BARS);
+    jobsPending |= JOB_CHART;
+    return true;
 }
 
 void displayShowCalibrating(bool show) {
     gfx->setTextSize(2);
     if (show) {
+        chart.paused = true;
         gfx->setTextColor(COLOR_YELLOW, COLOR_BLACK);
         gfx->setCursor(30, 256);
         gfx->print("Calibrating...");
     } else {
         gfx->fillRect(30, 256, 180, 20, COLOR_BLACK);
+        chart.paused = false;
+        uiInvalidate(chartWidget, UI_DIRTY_FULL);
     }
 }
 
-void displayRedrawUI(int percent) {
-    gfx->fillScreen(COLOR_BLACK);
+static void drawBattery(UiWidget *w, uint8_t dirty) {
+    tileAssume(&batteryTile, COLOR_BLACK);
+    jobsPending |= JOB_BATTERY;
+}
+
+static void onStartButton(UiWidget *w) {
+    startButtonPressed = true;
+}
+
+static void buildMainScreen() {
+    mainScreen = uiCreate(nullptr, UI_PANEL, 0, 0, 0, 0);
+    mainScreen->color = COLOR_BLACK;
+
+    startButton = uiCreate(mainScreen, UI_BUTTON, BTN_X, BTN_Y, BTN_WIDTH, BTN_HEIGHT);
+    startButton->radius = BTN_RADIUS;
+    startButton->flags |= UI_F_BORDER;
+    startButton->textSize = 2;
+    startButton->onTap = onStartButton;
     displayDrawButton(false);
-    displayDrawValueBoxes();
-    displayDrawVelocityBox();
-    displayDrawSwipeIndicator();
-    displayUpdateBattery(percent);
+
+    repsBox = uiCreate(mainScreen, UI_CUSTOM, BOX_LEFT_X, BOX_Y, BOX_WIDTH, BOX_HEIGHT);
+    repsBox->text = "REPS";
+    repsBox->draw = drawRepsBox;
+
+    timeBox = uiCreate(mainScreen, UI_CUSTOM, BOX_RIGHT_X, BOX_Y, BOX_WIDTH, BOX_HEIGHT);
+    timeBox->text = "TIME(s)";
+    timeBox->draw = drawTimeBox;
+
+    velocityBox = uiCreate(mainScreen, UI_CUSTOM, VBOX_X, VBOX_Y, VBOX_WIDTH, VBOX_HEIGHT);
+    velocityBox->text = "PEAK VEL (m/s)";
+    velocityBox->draw = drawVelocityBox;
+
+    chartWidget = uiCreate(mainScreen, UI_CUSTOM, CHART_X, CHART_Y, CHART_W, CHART_H);
+    chartWidget->draw = drawChart;
+
+    // Small white pill at the bottom: swipe up for settings
+    swipeBar = uiCreate(mainScreen, UI_PANEL, (LCD_WIDTH - BAR_WIDTH) / 2, LCD_HEIGHT - 8,
+                        BAR_WIDTH, BAR_HEIGHT);
+    swipeBar->color = COLOR_WHITE;
+    swipeBar->radius = 2;
+
+    UiWidget *battery = uiCreate(mainScreen, UI_CUSTOM, batteryTile.x, batteryTile.y,
+                                 batteryTile.w, batteryTile.h);
+    battery->draw = drawBattery;
+}
+
+void displayRedrawUI(int percent) {
+    shownBattery = percent;
+    tilesInvalidate();
+    uiShow(mainScreen);
+}
+
+bool displayMainHandleTouch(int16_t x, int16_t y) {
+    startButtonPressed = false;
+    uiTap(x, y);
+    return startButtonPressed;
+}
+
+// ============== Drags, flicks and hold-repeat ==============
+
+static bool inChartBars(int16_t x, int16_t y) {
+    return x >= CHART_X && x < CHART_X + CHART_BARS * CHART_BAR_W &&
+           y >= CHART_Y - CHART_TOUCH_SLOP && y < CHART_Y + CHART_H + CHART_TOUCH_SLOP;
+}
+
+// Drag pixels not yet worth a whole bar, for the touch that began at
+// (chartDragX0, chartDragY0)
+static int16_t chartDragRest = 0;
+static int16_t chartDragX0 = -1, chartDragY0 = -1;
+
+bool displayHandleDrag(int16_t x0, int16_t y0, int16_t x, int16_t dx, bool horizontal) {
+    if (!horizontal) return false;
+    if (uiActive() != mainScreen) return uiDrag(x0, y0, x);
+    if (!inChartBars(x0, y0)) return false;
+
+    if (x0 != chartDragX0 || y0 != chartDragY0) {
+        chartDragX0 = x0;
+        chartDragY0 = y0;
+        chartDragRest = 0;
+    }
+    // Dragging right brings older reps in from the left
+    chartDragRest += dx;
+    int bars = chartDragRest / CHART_BAR_W;
+    chartDragRest -= bars * CHART_BAR_W;
+    return bars && chartScroll(-bars);
+}
+
+bool displayHandleFlick(int16_t x0, int16_t y0, int16_t vx, bool horizontal) {
+    if (uiActive() != mainScreen || !horizontal || !inChartBars(x0, y0)) return false;
+    // The bars carry on for CHART_FLICK_GLIDE_MS at the release speed
+    int bars = (int32_t)vx * CHART_FLICK_GLIDE_MS / 1000 / CHART_BAR_W;
+    return bars && chartScroll(-bars);
+}
+
+bool displayHandleHoldRepeat(int16_t x, int16_t y) {
+    return uiRepeat(x, y);
+}
+
+bool displayCanHoldRepeat(int16_t x, int16_t y) {
+    return uiCanRepeat(x, y);
+}
+
+// ============== Render scheduler ==============
+// Callers only record state. At most once per DISPLAY_FRAME_MS, dirty
+// widgets are painted and then the readout jobs run, until
+// DISPLAY_FRAME_BUDGET_US is spent; the rest waits for the next frame.
+// A job whose tile is still being sent is also left for later, so a
+// frame never waits on the bus.
+
+static DisplayTile *jobTile(uint8_t job) {
+    switch (job) {
+        case JOB_REPS:    return &repsTile;
+        case JOB_TIME:    return &timeTile;
+        case JOB_PEAK:    return &peakTile;
+        case JOB_BATTERY: return &batteryTile;
+        default:          return nullptr;
+    }
+}
+
+// False if the bus queue was full and the job has to run again
+static bool runJob(uint8_t job) {
+    switch (job) {
+        case JOB_REPS:    return drawCounter(&repsTile, shownReps);
+        case JOB_TIME:    return drawCounter(&timeTile, shownTime);
+        case JOB_PEAK:    return drawPeak(shownPeak);
+        case JOB_BATTERY: return drawBatteryIcon(shownBattery);
+        case JOB_CHART:   chartRender(); return true;
+    }
+    return true;
+}
+
+void displayRender() {
+    unsigned long now = millis();
+    if (now - lastFrameMs < DISPLAY_FRAME_MS) return;
+    lastFrameMs = now;
+
+    // Readouts belong to the main screen; its boxes queue them again when shown
+    if (uiActive() != mainScreen) jobsPending = 0;
+
+    UiStats ui;
+    uiGetStats(&ui);
+    uint32_t paintedBefore = ui.painted;
+
+    uint32_t pixelsBefore = bus->pixelsSent();
+    uint32_t bytesBefore = bus->bytesSent();
+    unsigned long startUs = micros();
+    bool widgetsDone = uiRender(DISPLAY_FRAME_BUDGET_US);
+    uint8_t ran = 0, left = 0;
+
+    for (uint8_t job = JOB_REPS; job <= JOB_CHART; job <<= 1) {
+        if (!(jobsPending & job)) continue;
+        DisplayTile *t = jobTile(job);
+        if ((t && !t->sent) || (job == JOB_CHART && !chartSent) ||
+            micros() - startUs >= DISPLAY_FRAME_BUDGET_US) {
+            left++;
+            continue;
+        }
+        jobsPending &= ~job;
+        if (!runJob(job)) {
+            jobsPending |= job;
+            left++;
+            continue;
+        }
+        ran++;
+    }
+
+    if (!widgetsDone) left++;
+
+    // Idle frames (nothing painted, nothing waiting) are not counted
+    uiGetStats(&ui);
+    if (!ran && !left && ui.painted == paintedBefore) return;
+
+    uint32_t us = micros() - startUs;
+    stats.frames++;
+    stats.frameUs = us;
+    if (us > stats.frameMaxUs) stats.frameMaxUs = us;
+    stats.framePixels = bus->pixelsSent() - pixelsBefore;
+    stats.frameBytes = bus->bytesSent() - bytesBefore;
+    if (left) {
+        stats.framesOver++;
+        stats.deferred += left;
+    }
+
+#if DISPLAY_RAM_BUS
+    // Each screen once it has fully settled
+    static UiWidget *snapped = nullptr;
+    if (!left && uiActive() != snapped) {
+        snapped = uiActive();
+        if (snapped == mainScreen) snapshotScreen("main");
+        else if (snapped == settingsScreen) snapshotScreen("settings");
+        else if (snapped == pickerScreen) snapshotScreen("picker");
+    }
+#endif
+}
+
+// ============== Snapshots ==============
+
+bool displaySavePng(const char *path) {
+#if DISPLAY_RAM_BUS
+    File f = LittleFS.open(path, "w");
+    if (!f) return false;
+    bool ok = bus->writePng(f, ROW_OFFSET, LCD_HEIGHT);
+    f.close();
+    return ok;
+#else
+    return false;
+#endif
+}
+
+static void snapshotScreen(const char *name) {
+#if DISPLAY_RAM_BUS
+    char path[32];
+    if (!LittleFS.exists(DISPLAY_SNAPSHOT_DIR)) LittleFS.mkdir(DISPLAY_SNAPSHOT_DIR);
+    snprintf(path, sizeof(path), "%s/%s.png", DISPLAY_SNAPSHOT_DIR, name);
+    bool ok = displaySavePng(path);
+    Serial.printf("Display: %s %s (last frame %lu px, %lu bytes)\n", ok ? "saved" : "could not save", path,
+                  (unsigned long)stats.framePixels, (unsigned long)stats.frameBytes);
+#endif
 }
 
 void displayUpdateBattery(int percent) {
-    // Battery icon position (top-left area)
-    const int x = 27;   // left
-    const int y = 8;    // top
+    shownBattery = percent;
+    jobsPending |= JOB_BATTERY;
+}
+
+static bool drawBatteryIcon(int percent) {
+    unsigned long startUs = micros();
+    Arduino_Canvas *c = tileBegin(&batteryTile);
+
+    // Battery icon position, relative to the tile at (25, 6)
+    const int x = 2;    // left
+    const int y = 2;    // top
 
     // Battery dimensions
     const int bodyW = 22;
@@ -289,16 +1010,16 @@ void displayUpdateBattery(int percent) {
         fillColor = COLOR_YELLOW;
     }
 
-    // Clear previous icon area
-    gfx->fillRect(x - 2, y - 2, bodyW + tipW + 6, bodyH + 4, COLOR_BLACK);
+    // Start from a blank icon area
+    c->fillScreen(COLOR_BLACK);
 
     // Battery outline (body)
-    gfx->drawRect(x, y, bodyW, bodyH, COLOR_WHITE);
+    c->drawRect(x, y, bodyW, bodyH, COLOR_WHITE);
 
     // Battery tip (terminal)
     int tipX = x + bodyW;
     int tipY = y + (bodyH - tipH) / 2;
-    gfx->drawRect(tipX, tipY, tipW, tipH, COLOR_WHITE);
+    c->drawRect(tipX, tipY, tipW, tipH, COLOR_WHITE);
 
     // Fill level inside body
     int innerW = bodyW - 2;
@@ -306,8 +1027,10 @@ void displayUpdateBattery(int percent) {
     int fillW  = (innerW * percent) / 100;
 
     if (fillW > 0) {
-        gfx->fillRect(x + 1, y + 1, fillW, innerH, fillColor);
+        c->fillRect(x + 1, y + 1, fillW, innerH, fillColor);
     }
+
+    return tileFlush(&batteryTile, startUs);
 }
 
 Arduino_GFX* displayGetGFX() {
@@ -315,13 +1038,7 @@ Arduino_GFX* displayGetGFX() {
 }
 
 void displayDrawSwipeIndicator() {
-    // Small white pill/bar at bottom center of screen
-    const int barWidth = BAR_WIDTH;
-    const int barHeight = BAR_HEIGHT;
-    const int barY = LCD_HEIGHT - 8; // 8px from bottom
-    const int barX = (LCD_WIDTH - barWidth) / 2;
-    
-    gfx->fillRoundRect(barX, barY, barWidth, barHeight, 2, COLOR_WHITE);
+    uiInvalidate(swipeBar, UI_DIRTY_FULL);
 }
 
 // Button layout constants for settings
@@ -330,107 +1047,132 @@ static const int SETTINGS_BTN_H = 36;
 static const int SETTINGS_BTN_Y = 215;
 static const int SETTINGS_BTN_GAP = 10;
 static const int SETTINGS_BTN_LEFT_X = (LCD_WIDTH - SETTINGS_BTN_W * 2 - SETTINGS_BTN_GAP) / 2;
-static const int SETTINGS_BTN_RIGHT_X = SETTINGS_BTN_LEFT_X + SETTINGS_BTN_W + SETTINGS_BTN_GAP;
+static const int SETTINGS_TONE_Y = SETTINGS_BTN_Y + SETTINGS_BTN_H + 6;
+static const int SETTINGS_TONE_H = 24;
+
+static bool settingsTimeButtonPressed = false;
 
 void displayDrawBleButton() {
-    // Clear button area
-    gfx->fillRoundRect(SETTINGS_BTN_RIGHT_X, SETTINGS_BTN_Y, SETTINGS_BTN_W, SETTINGS_BTN_H, 4,
-                       bleEnabled ? COLOR_CYAN : COLOR_DARKGRAY);
-    gfx->drawRoundRect(SETTINGS_BTN_RIGHT_X, SETTINGS_BTN_Y, SETTINGS_BTN_W, SETTINGS_BTN_H, 4, COLOR_LIGHTGRAY);
-    gfx->setTextSize(2);
-    gfx->setTextColor(bleEnabled ? COLOR_BLACK : COLOR_WHITE);
-    gfx->setCursor(SETTINGS_BTN_RIGHT_X + 10, SETTINGS_BTN_Y + 10);
-    gfx->print(bleEnabled ? "BLE ON" : "BLE OFF");
+    bleButton->text = bleEnabled ? "BLE ON" : "BLE OFF";
+    bleButton->color = bleEnabled ? COLOR_CYAN : COLOR_DARKGRAY;
+    bleButton->textColor = bleEnabled ? COLOR_BLACK : COLOR_WHITE;
+    uiInvalidate(bleButton, UI_DIRTY_FULL);
 }
 
-void displayShowSettings() {
-    gfx->fillScreen(COLOR_BLACK);
-    
-    // Swipe-down indicator bar at top
-    const int barWidth = BAR_WIDTH;
-    const int barHeight = BAR_HEIGHT;
-    const int barX = (LCD_WIDTH - barWidth) / 2;
-    const int barY = 6;
+static void drawToneButton() {
+    bool on = getSonification();
+    toneButton->text = on ? "REP TONES ON" : "REP TONES OFF";
+    toneButton->color = on ? COLOR_GREEN : COLOR_DARKGRAY;
+    toneButton->textColor = on ? COLOR_BLACK : COLOR_WHITE;
+    uiInvalidate(toneButton, UI_DIRTY_FULL);
+}
 
-    gfx->fillRoundRect(barX, barY, barWidth, barHeight, 2, COLOR_WHITE);
-    
-    // Title
-    gfx->setTextSize(2);
-    gfx->setTextColor(COLOR_WHITE);
-    gfx->setCursor(60, 30);
-    gfx->print("Settings");
-    
-    // Display brightness
-    sliderInit(&brightnessSlider, 58, "BRIGHTNESS", 0, 255, 25, brightness, COLOR_YELLOW);
-    sliderDraw(&brightnessSlider);
+static void onBrightness(UiWidget *w) {
+    // Apply brightness immediately
+    brightness = w->value;
+    displaySetBacklight(brightness);
+}
 
-    // IMU sensitivity
-    sliderInit(&sensitivitySlider, 108, "SENSITIVITY", 0, 100, 25, getImuSensitivity(), COLOR_CYAN);
-    sliderDraw(&sensitivitySlider);
+static void onSensitivity(UiWidget *w) {
+    workoutSetSensitivity(w->value);
+}
 
-    // Volume
-    sliderInit(&volumeSlider, 158, "VOLUME", 0, 100, 10, getVolume(), COLOR_GREEN);
-    sliderDraw(&volumeSlider);
+static void onVolume(UiWidget *w) {
+    setVolume(w->value);
+}
 
-    // Set Time button (left)
-    gfx->fillRoundRect(SETTINGS_BTN_LEFT_X, SETTINGS_BTN_Y, SETTINGS_BTN_W, SETTINGS_BTN_H, 4, COLOR_DARKGRAY);
-    gfx->drawRoundRect(SETTINGS_BTN_LEFT_X, SETTINGS_BTN_Y, SETTINGS_BTN_W, SETTINGS_BTN_H, 4, COLOR_LIGHTGRAY);
-    gfx->setTextSize(2);
-    gfx->setTextColor(COLOR_WHITE);
-    gfx->setCursor(SETTINGS_BTN_LEFT_X + 6, SETTINGS_BTN_Y + 10);
-    gfx->print("SET TIME");
+static void onSetTime(UiWidget *w) {
+    settingsTimeButtonPressed = true;
+}
 
-    // BLE toggle button (right)
+static void onBleToggle(UiWidget *w) {
+    bleEnabled = !bleEnabled;
     displayDrawBleButton();
+    Serial.printf("BLE %s\n", bleEnabled ? "enabled" : "disabled");
 }
 
-bool displayInSettingsBackButton(int16_t x, int16_t y) {
-    return (x >= SETTINGS_BACK_X && x <= (SETTINGS_BACK_X + SETTINGS_BACK_W) &&
-            y >= SETTINGS_BACK_Y && y <= (SETTINGS_BACK_Y + SETTINGS_BACK_H));
+static void onToneToggle(UiWidget *w) {
+    setSonification(!getSonification());
+    drawToneButton();
+    Serial.printf("Rep tones %s\n", getSonification() ? "on" : "off");
 }
 
-static bool settingsTimeButtonPressed = false;
-
-bool displaySettingsHandleTouch(int16_t x, int16_t y) {
-    settingsTimeButtonPressed = false;
+static UiWidget *addSlider(UiWidget *parent, const char *label, uint16_t color, UiEventFn onChange) {
+    UiWidget *s = uiCreate(parent, UI_SLIDER, 0, 0, 0, 42);
+    s->text = label;
+    s->color = color;
+    s->hitSlop = 4;
+    s->onChange = onChange;
+    return s;
+}
 
-    if (sliderHandleTouch(&brightnessSlider, x, y)) {
-        // Apply brightness immediately
-        brightness = sliderGetValue(&brightnessSlider);
-        displaySetBacklight(brightness);
-        return true;
-    }
+static void buildSettingsScreen() {
+    settingsScreen = uiCreate(nullptr, UI_PANEL, 0, 0, 0, 0);
+    settingsScreen->color = COLOR_BLACK;
 
-    if (sliderHandleTouch(&sensitivitySlider, x, y)) {
-        const int value = sliderGetValue(&sensitivitySlider);
-        // Apply sensitivity to IMU
-        workoutSetSensitivity(sliderGetValue(&sensitivitySlider));
-        return true;
-    }
+    // Swipe-down indicator bar at top
+    UiWidget *bar = uiCreate(settingsScreen, UI_PANEL, (LCD_WIDTH - BAR_WIDTH) / 2, 6, BAR_WIDTH, BAR_HEIGHT);
+    bar->color = COLOR_WHITE;
+    bar->radius = 2;
+
+    UiWidget *title = uiCreate(settingsScreen, UI_LABEL, 60, 30, 96, 16);
+    uiSetText(title, "Settings", 2, COLOR_WHITE);
+
+    UiWidget *sliders = uiCreate(settingsScreen, UI_PANEL, 0, 50, LCD_WIDTH, 158);
+    sliders->color = COLOR_BLACK;
+    sliders->layout = UI_LAYOUT_COLUMN;
+    sliders->pad = 8;
+    sliders->gap = 8;
+    brightnessSlider = addSlider(sliders, "BRIGHTNESS", COLOR_YELLOW, onBrightness);
+    sensitivitySlider = addSlider(sliders, "SENSITIVITY", COLOR_CYAN, onSensitivity);
+    volumeSlider = addSlider(sliders, "VOLUME", COLOR_GREEN, onVolume);
+
+    UiWidget *buttons = uiCreate(settingsScreen, UI_PANEL, SETTINGS_BTN_LEFT_X, SETTINGS_BTN_Y,
+                                 SETTINGS_BTN_W * 2 + SETTINGS_BTN_GAP, SETTINGS_BTN_H);
+    buttons->color = COLOR_BLACK;
+    buttons->layout = UI_LAYOUT_ROW;
+    buttons->gap = SETTINGS_BTN_GAP;
+
+    UiWidget *timeButton = uiCreate(buttons, UI_BUTTON, 0, 0, 0, 0);
+    uiSetText(timeButton, "SET TIME", 2, COLOR_WHITE);
+    timeButton->radius = 4;
+    timeButton->flags |= UI_F_BORDER;
+    timeButton->onTap = onSetTime;
+
+    bleButton = uiCreate(buttons, UI_BUTTON, 0, 0, 0, 0);
+    bleButton->textSize = 2;
+    bleButton->radius = 4;
+    bleButton->flags |= UI_F_BORDER;
+    bleButton->onTap = onBleToggle;
+
+    // Velocity sonification, next to the volume it plays at
+    toneButton = uiCreate(settingsScreen, UI_BUTTON, SETTINGS_BTN_LEFT_X, SETTINGS_TONE_Y,
+                          SETTINGS_BTN_W * 2 + SETTINGS_BTN_GAP, SETTINGS_TONE_H);
+    toneButton->textSize = 2;
+    toneButton->radius = 4;
+    toneButton->flags |= UI_F_BORDER;
+    toneButton->onTap = onToneToggle;
+}
 
-    if (sliderHandleTouch(&volumeSlider, x, y)) {
-        // Apply volume
-        setVolume(sliderGetValue(&volumeSlider));
-        return true;
-    }
+void displayShowSettings() {
+    uiSetRange(brightnessSlider, 0, 255, 25, brightness);
+    uiSetRange(sensitivitySlider, 0, 100, 25, getImuSensitivity());
+    uiSetRange(volumeSlider, 0, 100, 10, getVolume());
+    displayDrawBleButton();
+    drawToneButton();
 
-    // Check SET TIME button (left)
-    if (x >= SETTINGS_BTN_LEFT_X && x <= SETTINGS_BTN_LEFT_X + SETTINGS_BTN_W &&
-        y >= SETTINGS_BTN_Y && y <= SETTINGS_BTN_Y + SETTINGS_BTN_H) {
-        settingsTimeButtonPressed = true;
-        return true;
-    }
+    tilesInvalidate();
+    uiShow(settingsScreen);
+}
 
-    // Check BLE toggle button (right)
-    if (x >= SETTINGS_BTN_RIGHT_X && x <= SETTINGS_BTN_RIGHT_X + SETTINGS_BTN_W &&
-        y >= SETTINGS_BTN_Y && y <= SETTINGS_BTN_Y + SETTINGS_BTN_H) {
-        bleEnabled = !bleEnabled;
-        displayDrawBleButton();
-        Serial.printf("BLE %s\n", bleEnabled ? "enabled" : "disabled");
-        return true;
-    }
+bool displayInSettingsBackButton(int16_t x, int16_t y) {
+    return (x >= SETTINGS_BACK_X && x <= (SETTINGS_BACK_X + SETTINGS_BACK_W) &&
+            y >= SETTINGS_BACK_Y && y <= (SETTINGS_BACK_Y + SETTINGS_BACK_H));
+}
 
-    return false;
+bool displaySettingsHandleTouch(int16_t x, int16_t y) {
+    settingsTimeButtonPressed = false;
+    return uiTap(x, y);
 }
 
 bool displaySettingsTimeButtonPressed() {
@@ -456,15 +1198,11 @@ void displaySetBleEnabled(bool enabled) {
 #define PICKER_BTN_HEIGHT   28
 #define PICKER_BTN_WIDTH    100
 
+enum { PICKER_YEAR, PICKER_MONTH, PICKER_DAY, PICKER_HOUR, PICKER_MINUTE };
+
 // Days in each month (non-leap year)
 static const uint8_t daysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
 
-// Picker state
-static uint16_t pickerYear = 2024;
-static uint8_t pickerMonth = 1;
-static uint8_t pickerDay = 1;
-static uint8_t pickerHour = 12;
-static uint8_t pickerMinute = 0;
 static bool pickerConfirmed = false;
 
 static uint8_t getMaxDays(uint16_t year, uint8_t month) {
@@ -477,132 +1215,67 @@ static uint8_t getMaxDays(uint16_t year, uint8_t month) {
     return days;
 }
 
-static void pickerDrawRow(int row, const char* label, const char* value) {
-    int y = PICKER_ROW_START_Y + row * PICKER_ROW_HEIGHT;
-
-    // Row background
-    gfx->fillRoundRect(PICKER_ROW_X, y, PICKER_ROW_WIDTH, PICKER_ROW_HEIGHT - 4, 4, COLOR_DARKGRAY);
+// Year or month changed: clamp the day to the new month
+static void onPickerMonth(UiWidget *w) {
+    UiWidget *day = pickerRows[PICKER_DAY];
+    uiSetRange(day, 1, getMaxDays(pickerRows[PICKER_YEAR]->value, pickerRows[PICKER_MONTH]->value),
+               1, day->value);
+}
 
-    // Label (left side)
-    gfx->setTextSize(1);
-    gfx->setTextColor(COLOR_LIGHTGRAY);
-    gfx->setCursor(PICKER_ROW_X + 8, y + 12);
-    gfx->print(label);
+static void onPickerConfirm(UiWidget *w) {
+    pickerConfirmed = true;
+}
 
-    // Value (center)
-    gfx->setTextSize(2);
-    gfx->setTextColor(COLOR_WHITE);
-    int valueWidth = strlen(value) * 12;
-    gfx->setCursor(PICKER_ROW_X + (PICKER_ROW_WIDTH - valueWidth) / 2, y + 8);
-    gfx->print(value);
+static void buildPickerScreen() {
+    static const char *const labels[5] = {"YEAR", "MONTH", "DAY", "HOUR", "MIN"};
 
-    // Minus indicator (left)
-    gfx->setTextSize(2);
-    gfx->setTextColor(COLOR_LIGHTGRAY);
-    gfx->setCursor(PICKER_ROW_X + 8, y + 8);
-    gfx->print("-");
+    pickerScreen = uiCreate(nullptr, UI_PANEL, 0, 0, 0, 0);
+    pickerScreen->color = COLOR_BLACK;
 
-    // Plus indicator (right)
-    gfx->setCursor(PICKER_ROW_X + PICKER_ROW_WIDTH - 20, y + 8);
-    gfx->print("+");
-}
+    UiWidget *title = uiCreate(pickerScreen, UI_LABEL, 36, 20, 180, 16);
+    uiSetText(title, "SET DATE & TIME", 2, COLOR_WHITE);
 
-static void pickerUpdateRow(int row) {
-    char buf[8];
-    switch (row) {
-        case 0: sprintf(buf, "%04d", pickerYear); pickerDrawRow(0, "YEAR", buf); break;
-        case 1: sprintf(buf, "%02d", pickerMonth); pickerDrawRow(1, "MONTH", buf); break;
-        case 2: sprintf(buf, "%02d", pickerDay); pickerDrawRow(2, "DAY", buf); break;
-        case 3: sprintf(buf, "%02d", pickerHour); pickerDrawRow(3, "HOUR", buf); break;
-        case 4: sprintf(buf, "%02d", pickerMinute); pickerDrawRow(4, "MIN", buf); break;
+    UiWidget *rows = uiCreate(pickerScreen, UI_PANEL, PICKER_ROW_X, PICKER_ROW_START_Y,
+                              PICKER_ROW_WIDTH, 5 * PICKER_ROW_HEIGHT);
+    rows->color = COLOR_BLACK;
+    rows->layout = UI_LAYOUT_COLUMN;
+    rows->gap = 4;
+    for (int i = 0; i < 5; i++) {
+        pickerRows[i] = uiCreate(rows, UI_STEPPER, 0, 0, 0, PICKER_ROW_HEIGHT - 4);
+        pickerRows[i]->text = labels[i];
+        pickerRows[i]->format = (i == PICKER_YEAR) ? "%04d" : "%02d";
     }
+    pickerRows[PICKER_YEAR]->onChange = onPickerMonth;
+    pickerRows[PICKER_MONTH]->onChange = onPickerMonth;
+
+    UiWidget *confirm = uiCreate(pickerScreen, UI_BUTTON, (LCD_WIDTH - PICKER_BTN_WIDTH) / 2, PICKER_BTN_Y,
+                                 PICKER_BTN_WIDTH, PICKER_BTN_HEIGHT);
+    uiSetText(confirm, "CONFIRM", 2, COLOR_BLACK);
+    confirm->color = COLOR_WHITE;
+    confirm->radius = 4;
+    confirm->onTap = onPickerConfirm;
 }
 
 void displayShowDateTimePicker() {
     pickerConfirmed = false;
 
     // Load current RTC values if set, otherwise use defaults
+    DateTime dt = {2024, 1, 1, 12, 0};
     if (rtcIsSet()) {
-        DateTime dt;
         rtcGetDateTime(&dt);
-        pickerYear = dt.year;
-        pickerMonth = dt.month;
-        pickerDay = dt.day;
-        pickerHour = dt.hour;
-        pickerMinute = dt.minute;
-    } else {
-        pickerYear = 2024;
-        pickerMonth = 1;
-        pickerDay = 1;
-        pickerHour = 12;
-        pickerMinute = 0;
     }
-
-    gfx->fillScreen(COLOR_BLACK);
-
-    // Title
-    gfx->setTextSize(2);
-    gfx->setTextColor(COLOR_WHITE);
-    gfx->setCursor(36, 20);
-    gfx->print("SET DATE & TIME");
-
-    // Draw all rows
-    for (int i = 0; i < 5; i++) {
-        pickerUpdateRow(i);
-    }
-
-    // Confirm button
-    int btnX = (LCD_WIDTH - PICKER_BTN_WIDTH) / 2;
-    gfx->fillRoundRect(btnX, PICKER_BTN_Y, PICKER_BTN_WIDTH, PICKER_BTN_HEIGHT, 4, COLOR_WHITE);
-    gfx->setTextSize(2);
-    gfx->setTextColor(COLOR_BLACK);
-    gfx->setCursor(btnX + 14, PICKER_BTN_Y + 6);
-    gfx->print("CONFIRM");
+    uiSetRange(pickerRows[PICKER_YEAR], 2024, 2099, 1, dt.year);
+    uiSetRange(pickerRows[PICKER_MONTH], 1, 12, 1, dt.month);
+    uiSetRange(pickerRows[PICKER_DAY], 1, getMaxDays(dt.year, dt.month), 1, dt.day);
+    uiSetRange(pickerRows[PICKER_HOUR], 0, 23, 1, dt.hour);
+    uiSetRange(pickerRows[PICKER_MINUTE], 0, 59, 1, dt.minute);
+
+    tilesInvalidate();
+    uiShow(pickerScreen);
 }
 
 bool displayDateTimePickerHandleTouch(int16_t x, int16_t y) {
-    // Check confirm button
-    int btnX = (LCD_WIDTH - PICKER_BTN_WIDTH) / 2;
-    if (x >= btnX && x <= btnX + PICKER_BTN_WIDTH &&
-        y >= PICKER_BTN_Y && y <= PICKER_BTN_Y + PICKER_BTN_HEIGHT) {
-        pickerConfirmed = true;
-        return true;
-    }
-
-    // Check which row was touched
-    for (int row = 0; row < 5; row++) {
-        int rowY = PICKER_ROW_START_Y + row * PICKER_ROW_HEIGHT;
-        if (y >= rowY && y < rowY + PICKER_ROW_HEIGHT - 4) {
-            // Determine if left or right half
-            int midX = PICKER_ROW_X + PICKER_ROW_WIDTH / 2;
-            int delta = (x < midX) ? -1 : 1;
-
-            switch (row) {
-                case 0: // Year
-                    pickerYear = constrain(pickerYear + delta, 2024, 2099);
-                    break;
-                case 1: // Month
-                    pickerMonth = constrain(pickerMonth + delta, 1, 12);
-                    // Clamp day if needed
-                    pickerDay = min(pickerDay, getMaxDays(pickerYear, pickerMonth));
-                    pickerUpdateRow(2); // Update day display
-                    break;
-                case 2: // Day
-                    pickerDay = constrain(pickerDay + delta, 1, getMaxDays(pickerYear, pickerMonth));
-                    break;
-                case 3: // Hour
-                    pickerHour = constrain(pickerHour + delta, 0, 23);
-                    break;
-                case 4: // Minute
-                    pickerMinute = constrain(pickerMinute + delta, 0, 59);
-                    break;
-            }
-            pickerUpdateRow(row);
-            return true;
-        }
-    }
-
-    return false;
+    return uiTap(x, y);
 }
 
 bool displayDateTimePickerIsConfirmed() {
@@ -610,9 +1283,9 @@ bool displayDateTimePickerIsConfirmed() {
 }
 
 void displayDateTimePickerGetValues(uint16_t* year, uint8_t* month, uint8_t* day, uint8_t* hour, uint8_t* minute) {
-    *year = pickerYear;
-    *month = pickerMonth;
-    *day = pickerDay;
-    *hour = pickerHour;
-    *minute = pickerMinute;
+    *year = pickerRows[PICKER_YEAR]->value;
+    *month = pickerRows[PICKER_MONTH]->value;
+    *day = pickerRows[PICKER_DAY]->value;
+    *hour = pickerRows[PICKER_HOUR]->value;
+    *minute = pickerRows[PICKER_MINUTE]->value;
 }
@@ -43,12 +43,41 @@ void displayUpdateTime(int value);
 // Update the peak velocity display
 void displayUpdatePeakVelocity(float value);
 
+// Rep chart: per-rep mean velocity bars and a scrolling velocity trace.
+// Samples are only binned here; drawing happens in displayUpdateChart(),
+// a few columns per call within CHART_PIXEL_BUDGET.
+void displayChartAddSample(float velocity, uint32_t nowMs);
+void displayUpdateChart();
+void displayResetChart();
+
 // Show calibrating message
 void displayShowCalibrating(bool show);
 
-// Redraw entire UI (after wake)
+// Show the main screen (after wake, or coming back from settings)
 void displayRedrawUI(int percent);
 
+// Main screen tap; returns true if it hit the start/stop button
+bool displayMainHandleTouch(int16_t x, int16_t y);
+
+// Gestures on whatever screen is up (see TouchInfo in touch.h). A
+// horizontal drag moves a slider, or on the main screen scrolls the rep
+// chart through earlier reps; a flick there carries the scroll on.
+// Hold-repeat steps sliders and steppers. Each returns true if something
+// changed.
+bool displayHandleDrag(int16_t x0, int16_t y0, int16_t x, int16_t dx, bool horizontal);
+bool displayHandleFlick(int16_t x0, int16_t y0, int16_t vx, bool horizontal);
+bool displayHandleHoldRepeat(int16_t x, int16_t y);
+
+// Hold filter for touchSetHoldFilter(): only sliders and steppers repeat,
+// so holding a button still gives its tap on release
+bool displayCanHoldRepeat(int16_t x, int16_t y);
+
+// Screens are widget trees (ui.h): the draw, show and update functions only
+// record state and displayRender() paints it, at most once per
+// DISPLAY_FRAME_MS and for about DISPLAY_FRAME_BUDGET_US; whatever is left
+// waits for the next frame. Call it from every loop that waits on the screen.
+void displayRender();
+
 // Update battery indicator dot (top-left corner)
 // green = >60%, yellow = 20-60%, red = <20%
 void displayUpdateBattery(int percent);
@@ -56,6 +85,37 @@ void displayUpdateBattery(int percent);
 // Get the GFX object for direct access if needed
 Arduino_GFX* displayGetGFX();
 
+// Partial-update counters (readouts are flushed as changed rectangles only)
+typedef struct {
+    uint32_t flushes;      // Windowed bursts sent
+    uint32_t skipped;      // Updates that changed no pixels
+    uint32_t spiBytes;     // Bytes sent by all flushes (pixels + window commands)
+    uint32_t lastBytes;
+    uint32_t lastUs;       // CPU time of the last update (render, diff, queue)
+    uint32_t maxUs;
+    uint32_t cpuUsPerSec;  // CPU time in updates over the last second
+
+    // Render scheduler (displayRender)
+    uint32_t frames;       // Frames that painted or deferred something
+    uint32_t frameUs;      // CPU time of the last frame
+    uint32_t frameMaxUs;
+    uint32_t framesOver;   // Frames that left work for the next one
+    uint32_t deferred;     // Widget passes and readouts carried over
+    uint32_t framePixels;  // Pixels the last frame pushed to the panel
+    uint32_t frameBytes;   // Bus bytes of the last frame (commands included)
+
+    // Bus totals since displayInit() (pixelsSent() and bytesSent())
+    uint32_t busPixels;
+    uint32_t busBytes;
+} DisplayStats;
+
+void displayGetStats(DisplayStats* stats);
+
+// Write the visible screen to a LittleFS file as a PNG. Only works with
+// DISPLAY_RAM_BUS, which also saves each screen (main, settings, picker,
+// error) under DISPLAY_SNAPSHOT_DIR the first time it is fully drawn.
+bool displaySavePng(const char* path);
+
 // Settings page
 void displayDrawSwipeIndicator();
 void displayShowSettings();
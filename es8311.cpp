@@ -15,9 +15,21 @@
 
 #include "Wire.h"
 
+/* Registers 0x00 - 0x45 are shadowed; the chip ID registers (0xFD - 0xFF) are always read */
+#define ES8311_SHADOW_SIZE   (ES8311_GP_REG45 + 1)
+/* Clean registers a burst may rewrite to join two dirty runs */
+#define ES8311_BURST_MAX_GAP 2
+
 typedef struct {
     i2c_port_t port;
     uint16_t dev_addr;
+    uint8_t shadow[ES8311_SHADOW_SIZE];  /* Last value read from or written to the chip */
+    bool known[ES8311_SHADOW_SIZE];      /* shadow[] matches the chip */
+    bool dirty[ES8311_SHADOW_SIZE];      /* Written during a batch, not sent yet */
+    bool written[ES8311_SHADOW_SIZE];    /* Set by us since the last reset */
+    bool batching;
+    uint32_t reads;                      /* I2C transactions */
+    uint32_t writes;
 } es8311_dev_t;
 
 /*
@@ -180,6 +192,16 @@ static bool i2c_reg8_write(uint8_t dev_addr, uint8_t reg_addr, uint8_t *data, ui
 static inline esp_err_t es8311_write_reg(es8311_handle_t dev, uint8_t reg_addr, uint8_t data)
 {
     es8311_dev_t *es = (es8311_dev_t *) dev;
+    if (reg_addr < ES8311_SHADOW_SIZE) {
+        es->shadow[reg_addr] = data;
+        es->known[reg_addr] = true;
+        es->written[reg_addr] = true;
+        if (es->batching) {
+            es->dirty[reg_addr] = true;
+            return ESP_OK;
+        }
+    }
+    es->writes++;
     if (i2c_reg8_write(es->dev_addr, reg_addr, &data, 1))
       return ESP_OK;
     else
@@ -192,12 +214,119 @@ static inline esp_err_t es8311_read_reg(es8311_handle_t dev, uint8_t reg_addr, u
 {
     es8311_dev_t *es = (es8311_dev_t *) dev;
 
-    if (i2c_reg8_read(es->dev_addr, reg_addr, reg_value, 1))
-      return ESP_OK;
-    else
+    if (reg_addr < ES8311_SHADOW_SIZE && es->known[reg_addr]) {
+        *reg_value = es->shadow[reg_addr];
+        return ESP_OK;
+    }
+
+    es->reads++;
+    if (!i2c_reg8_read(es->dev_addr, reg_addr, reg_value, 1))
       return ESP_FAIL;
     // return i2c_master_write_read_device(es->port, es->dev_addr, &reg_addr, 1, reg_value, 1, pdMS_TO_TICKS(1000));
 
+    if (reg_addr < ES8311_SHADOW_SIZE) {
+        es->shadow[reg_addr] = *reg_value;
+        es->known[reg_addr] = true;
+    }
+    return ESP_OK;
+}
+
+/*
+ * Forget the shadow after a chip reset: every register is back to its default
+ */
+static void es8311_shadow_reset(es8311_dev_t *es)
+{
+    memset(es->known, 0, sizeof(es->known));
+    memset(es->dirty, 0, sizeof(es->dirty));
+    memset(es->written, 0, sizeof(es->written));
+}
+
+void es8311_batch_begin(es8311_handle_t dev)
+{
+    ((es8311_dev_t *) dev)->batching = true;
+}
+
+esp_err_t es8311_batch_commit(es8311_handle_t dev)
+{
+    es8311_dev_t *es = (es8311_dev_t *) dev;
+    esp_err_t ret = ESP_OK;
+    es->batching = false;
+
+    /* One burst per run of dirty registers (the address auto-increments).
+     * A short gap of registers whose value is known is rewritten rather
+     * than paying for another transaction. */
+    int reg = 0;
+    while (reg < ES8311_SHADOW_SIZE) {
+        if (!es->dirty[reg]) {
+            reg++;
+            continue;
+        }
+        int end = reg + 1;
+        while (end < ES8311_SHADOW_SIZE) {
+            if (es->dirty[end]) {
+                end++;
+                continue;
+            }
+            int next = end;
+            while (next < ES8311_SHADOW_SIZE && next - end < ES8311_BURST_MAX_GAP &&
+                   !es->dirty[next] && es->known[next]) {
+                next++;
+            }
+            if (next < ES8311_SHADOW_SIZE && es->dirty[next] && next - end <= ES8311_BURST_MAX_GAP) {
+                end = next;
+            } else {
+                break;
+            }
+        }
+
+        es->writes++;
+        if (!i2c_reg8_write(es->dev_addr, reg, &es->shadow[reg], end - reg)) {
+            ESP_LOGE(TAG, "Burst write of REG%02X - REG%02X failed", reg, end - 1);
+            ret = ESP_FAIL;
+        }
+        for (int i = reg; i < end; i++) {
+            es->dirty[i] = false;
+        }
+        reg = end;
+    }
+    return ret;
+}
+
+esp_err_t es8311_restore(es8311_handle_t dev)
+{
+    es8311_dev_t *es = (es8311_dev_t *) dev;
+
+    /* Clock manager setup is written by init and never matches its default,
+     * so a read-back that still holds it means nothing was lost */
+    uint8_t reg01;
+    es->reads++;
+    if (!i2c_reg8_read(es->dev_addr, ES8311_CLK_MANAGER_REG01, &reg01, 1)) {
+        return ESP_FAIL;
+    }
+    if (es->written[ES8311_CLK_MANAGER_REG01] && reg01 == es->shadow[ES8311_CLK_MANAGER_REG01]) {
+        return ESP_OK;
+    }
+
+    ESP_LOGI(TAG, "Register state lost, restoring");
+    for (int reg = 0; reg < ES8311_SHADOW_SIZE; reg++) {
+        es->dirty[reg] = es->written[reg];
+        /* Registers we never wrote went back to their defaults */
+        if (!es->written[reg]) {
+            es->known[reg] = false;
+        }
+    }
+    return es8311_batch_commit(dev);
+}
+
+void es8311_i2c_counts(es8311_handle_t dev, uint32_t *reads, uint32_t *writes)
+{
+    es8311_dev_t *es = (es8311_dev_t *) dev;
+    if (reads) {
+        *reads = es->reads;
+    }
+    if (writes) {
+        *writes = es->writes;
+    }
 }
 
 /*
@@ -370,17 +499,25 @@ esp_err_t es8311_init(es8311_handle_t dev, const es8311_clock_config_t *const cl
     }
 
 
-    /* Reset ES8311 to its default */
+    /* Reset ES8311 to its default (sent as it goes, the delay matters) */
+    es8311_dev_t *es = (es8311_dev_t *) dev;
+    esp_err_t ret = ESP_OK;
+    es->batching = false;
     ESP_RETURN_ON_ERROR(es8311_write_reg(dev, ES8311_RESET_REG00, 0x1F), TAG, "I2C read/write error");
+    es8311_shadow_reset(es);
     vTaskDelay(pdMS_TO_TICKS(20));
     ESP_RETURN_ON_ERROR(es8311_write_reg(dev, ES8311_RESET_REG00, 0x00), TAG, "I2C read/write error");
     ESP_RETURN_ON_ERROR(es8311_write_reg(dev, ES8311_RESET_REG00, 0x80), TAG, "I2C read/write error"); // Power-on command
 
+    /* The rest goes out in bursts. Read-modify-writes read each register
+     * once; after that they work on the shadow. */
+    es8311_batch_begin(dev);
+
     /* Setup clock: source, polarity and clock dividers */
-    ESP_RETURN_ON_ERROR(es8311_clock_config(dev, clk_cfg, res_out), TAG, "");
+    ESP_GOTO_ON_ERROR(es8311_clock_config(dev, clk_cfg, res_out), fail, TAG, "");
 
     /* Setup audio format (fmt): master/slave, resolution, I2S */
-    ESP_RETURN_ON_ERROR(es8311_fmt_config(dev, res_in, res_out), TAG, "");
+    ESP_GOTO_ON_ERROR(es8311_fmt_config(dev, res_in, res_out), fail, TAG, "");
 
     ESP_RETURN_ON_ERROR(es8311_write_reg(dev, ES8311_SYSTEM_REG0D, 0x01), TAG, "I2C read/write error"); // Power up analog circuitry - NOT default
     ESP_RETURN_ON_ERROR(es8311_write_reg(dev, ES8311_SYSTEM_REG0E, 0x02), TAG, "I2C read/write error"); // Enable analog PGA, enable ADC modulator - NOT default
@@ -389,7 +526,11 @@ esp_err_t es8311_init(es8311_handle_t dev, const es8311_clock_config_t *const cl
     ESP_RETURN_ON_ERROR(es8311_write_reg(dev, ES8311_ADC_REG1C, 0x6A), TAG, "I2C read/write error"); // ADC Equalizer bypass, cancel DC offset in digital domain
     ESP_RETURN_ON_ERROR(es8311_write_reg(dev, ES8311_DAC_REG37, 0x08), TAG, "I2C read/write error"); // Bypass DAC equalizer - NOT default
 
-    return ESP_OK;
+    return es8311_batch_commit(dev);
+
+fail:
+    es->batching = false;
+    return ret;
 }
 
 void es8311_delete(es8311_handle_t dev)
@@ -473,7 +614,7 @@ void es8311_register_dump(es8311_handle_t dev)
 {
     for (int reg = 0; reg < 0x4A; reg++) {
         uint8_t value;
-        ESP_ERROR_CHECK(es8311_read_reg(dev, reg, &value));
+        ESP_ERROR_CHECK(i2c_reg8_read(((es8311_dev_t *) dev)->dev_addr, reg, &value, 1) ? ESP_OK : ESP_FAIL);
         printf("REG:%02x: %02x", reg, value);
     }
 }
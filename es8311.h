@@ -205,6 +205,54 @@ esp_err_t es8311_voice_fade(es8311_handle_t dev, const es8311_fade_t fade);
  */
 esp_err_t es8311_microphone_fade(es8311_handle_t dev, const es8311_fade_t fade);
 
+/**
+ * @brief Start collecting register writes
+ *
+ * Register values are kept in a RAM shadow, so reads of registers already
+ * read or written cost no I2C transaction. Between es8311_batch_begin() and
+ * es8311_batch_commit() writes only update the shadow.
+ *
+ * @param dev ES8311 handle
+ */
+void es8311_batch_begin(es8311_handle_t dev);
+
+/**
+ * @brief Send the writes collected since es8311_batch_begin()
+ *
+ * Consecutive registers go out as one burst (the register address
+ * auto-increments), so a batch costs one transaction per run of registers.
+ *
+ * @param dev ES8311 handle
+ * @return
+ *     - ESP_OK success
+ *     - Else I2C write error
+ */
+esp_err_t es8311_batch_commit(es8311_handle_t dev);
+
+/**
+ * @brief Bring the chip back to the configured state after a sleep
+ *
+ * Reads back one register written by es8311_init(). If it still holds its
+ * value nothing else is sent; otherwise every register written since
+ * es8311_init() is restored from the shadow in bursts, without the reset
+ * sequence and its delay.
+ *
+ * @param dev ES8311 handle
+ * @return
+ *     - ESP_OK success
+ *     - Else I2C read/write error
+ */
+esp_err_t es8311_restore(es8311_handle_t dev);
+
+/**
+ * @brief Get the number of I2C transactions made so far
+ *
+ * @param dev ES8311 handle
+ * @param[out] reads  Read transactions (can be NULL)
+ * @param[out] writes Write transactions, a burst counting as one (can be NULL)
+ */
+void es8311_i2c_counts(es8311_handle_t dev, uint32_t *reads, uint32_t *writes);
+
 /**
  * @brief Create ES8311 object and return its handle
  *
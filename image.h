@@ -5,7 +5,9 @@
 
 // Image: 240x280, RGB565 Big Endian
 // Background: BLACK, Logo: #EE6B74
-const uint16_t gImage_image[67200] PROGMEM = {
+// Source data only: splash.h compresses it at compile time and the raw
+// array is never stored in flash
+constexpr uint16_t gImage_image[67200] = {
   0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
   0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
   0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
@@ -0,0 +1,332 @@
+#include "lcdbus.h"
+#include <driver/gpio.h>
+#include <esp_heap_caps.h>
+#include <freertos/task.h>
+
+#define BAND_PIXELS (LCD_WIDTH * LCD_DMA_BAND_LINES)
+#define BAND_BYTES  (BAND_PIXELS * 2)
+
+// MIPI DCS window commands
+#define CMD_CASET 0x2A
+#define CMD_RASET 0x2B
+#define CMD_RAMWR 0x2C
+
+LcdDmaBus::LcdDmaBus(int8_t dc, int8_t cs, int8_t sck, int8_t mosi)
+    : _dc(dc), _cs(cs), _sck(sck), _mosi(mosi) {
+    memset(_trans, 0, sizeof(_trans));
+}
+
+bool LcdDmaBus::begin(int32_t speed, int8_t dataMode) {
+    // The display is set up twice (full panel, then the visible area)
+    if (_started) return true;
+
+    if (speed == GFX_NOT_DEFINED) speed = LCD_SPI_HZ;
+    if (dataMode == GFX_NOT_DEFINED) dataMode = 0;
+
+    gpio_reset_pin((gpio_num_t)_dc);
+    gpio_set_direction((gpio_num_t)_dc, GPIO_MODE_OUTPUT);
+
+    spi_bus_config_t buscfg;
+    memset(&buscfg, 0, sizeof(buscfg));
+    buscfg.mosi_io_num = _mosi;
+    buscfg.miso_io_num = -1;
+    buscfg.sclk_io_num = _sck;
+    buscfg.quadwp_io_num = -1;
+    buscfg.quadhd_io_num = -1;
+    buscfg.max_transfer_sz = BAND_BYTES;
+    if (spi_bus_initialize(SPI2_HOST, &buscfg, SPI_DMA_CH_AUTO) != ESP_OK) {
+        Serial.println("LCD: SPI bus init failed");
+        return false;
+    }
+
+    spi_device_interface_config_t devcfg;
+    memset(&devcfg, 0, sizeof(devcfg));
+    devcfg.mode = dataMode;
+    devcfg.clock_speed_hz = speed;
+    devcfg.spics_io_num = _cs;
+    devcfg.queue_size = 2;   // One per band
+    if (spi_bus_add_device(SPI2_HOST, &devcfg, &_dev) != ESP_OK) {
+        Serial.println("LCD: SPI device add failed");
+        return false;
+    }
+
+    _band[0] = (uint16_t *)heap_caps_malloc(BAND_BYTES, MALLOC_CAP_DMA);
+    _band[1] = (uint16_t *)heap_caps_malloc(BAND_BYTES, MALLOC_CAP_DMA);
+    _data = (uint8_t *)heap_caps_malloc(LCD_CMD_BUF, MALLOC_CAP_DMA);
+    _rects = xQueueCreate(LCD_DMA_QUEUE_LEN, sizeof(Rect));
+    if (!_band[0] || !_band[1] || !_data || !_rects) {
+        Serial.println("LCD: DMA buffer allocation failed");
+        return false;
+    }
+
+    // Above the Arduino loop so a queued rectangle starts right away; it
+    // sleeps while DMA runs
+    if (xTaskCreate(flushTask, "lcd_flush", 3072, this, 2, nullptr) != pdPASS) {
+        Serial.println("LCD: flush task creation failed");
+        return false;
+    }
+
+    _started = true;
+    return true;
+}
+
+// ============== Transactions ==============
+
+void LcdDmaBus::sendBytes(const uint8_t *data, uint32_t len, bool dc) {
+    waitBands();
+    gpio_set_level((gpio_num_t)_dc, dc ? 1 : 0);
+
+    spi_transaction_t t;
+    memset(&t, 0, sizeof(t));
+    t.length = len * 8;
+    if (len <= 4) {
+        t.flags = SPI_TRANS_USE_TXDATA;
+        memcpy(t.tx_data, data, len);
+    } else {
+        t.tx_buffer = data;
+    }
+    spi_device_polling_transmit(_dev, &t);
+    _bytes += len;
+}
+
+void LcdDmaBus::flushData() {
+    if (_dataLen == 0) return;
+    sendBytes(_data, _dataLen, true);
+    _dataLen = 0;
+}
+
+// Band to fill next; waits for its previous transfer first
+uint16_t *LcdDmaBus::nextBand() {
+    uint8_t slot = _bandNext;
+    while (_inFlight[slot]) {
+        spi_transaction_t *done;
+        spi_device_get_trans_result(_dev, &done, portMAX_DELAY);
+        _inFlight[done == &_trans[0] ? 0 : 1] = false;
+    }
+    return _band[slot];
+}
+
+void LcdDmaBus::queueBand(uint32_t bytes) {
+    uint8_t slot = _bandNext;
+    if (!_inFlight[0] && !_inFlight[1]) gpio_set_level((gpio_num_t)_dc, 1);
+
+    memset(&_trans[slot], 0, sizeof(spi_transaction_t));
+    _trans[slot].length = bytes * 8;
+    _trans[slot].tx_buffer = _band[slot];
+    spi_device_queue_trans(_dev, &_trans[slot], portMAX_DELAY);
+
+    _inFlight[slot] = true;
+    _bandNext ^= 1;
+    _bytes += bytes;
+}
+
+void LcdDmaBus::waitBands() {
+    while (_inFlight[0] || _inFlight[1]) {
+        spi_transaction_t *done;
+        spi_device_get_trans_result(_dev, &done, portMAX_DELAY);
+        _inFlight[done == &_trans[0] ? 0 : 1] = false;
+    }
+}
+
+// ============== Arduino_DataBus ==============
+
+void LcdDmaBus::beginWrite() {
+    waitIdle();
+}
+
+void LcdDmaBus::endWrite() {
+    // The last pixel band may still be in flight; the next transaction waits for it
+    flushData();
+}
+
+void LcdDmaBus::writeCommand(uint8_t c) {
+    flushData();
+    sendBytes(&c, 1, false);
+}
+
+void LcdDmaBus::writeCommand16(uint16_t c) {
+    flushData();
+    uint8_t b[2] = {(uint8_t)(c >> 8), (uint8_t)c};
+    sendBytes(b, 2, false);
+}
+
+void LcdDmaBus::writeCommandBytes(uint8_t *data, uint32_t len) {
+    flushData();
+    sendBytes(data, len, false);
+}
+
+void LcdDmaBus::write(uint8_t d) {
+    if (_dataLen == LCD_CMD_BUF) flushData();
+    _data[_dataLen++] = d;
+}
+
+void LcdDmaBus::write16(uint16_t d) {
+    write(d >> 8);
+    write(d);
+}
+
+void LcdDmaBus::writeBytes(uint8_t *data, uint32_t len) {
+    while (len--) write(*data++);
+}
+
+void LcdDmaBus::writeRepeat(uint16_t p, uint32_t len) {
+    flushData();
+    waitBands();
+    _pixels += len;
+
+    // Both bands hold the color, then they are sent alternately as is
+    uint16_t swapped = (p >> 8) | (p << 8);
+    uint32_t fill = min(len, (uint32_t)BAND_PIXELS);
+    for (uint32_t i = 0; i < fill; i++) {
+        _band[0][i] = swapped;
+        _band[1][i] = swapped;
+    }
+
+    while (len > 0) {
+        uint32_t n = min(len, (uint32_t)BAND_PIXELS);
+        nextBand();
+        queueBand(n * 2);
+        len -= n;
+    }
+}
+
+void LcdDmaBus::writePixels(uint16_t *data, uint32_t len) {
+    flushData();
+    _pixels += len;
+
+    while (len > 0) {
+        uint32_t n = min(len, (uint32_t)BAND_PIXELS);
+        uint16_t *band = nextBand();
+        for (uint32_t i = 0; i < n; i++) {
+            uint16_t p = data[i];
+            band[i] = (p >> 8) | (p << 8);
+        }
+        queueBand(n * 2);
+        data += n;
+        len -= n;
+    }
+}
+
+void LcdDmaBus::writeIndexedPixels(uint8_t *data, uint16_t *idx, uint32_t len) {
+    flushData();
+    _pixels += len;
+
+    while (len > 0) {
+        uint32_t n = min(len, (uint32_t)BAND_PIXELS);
+        uint16_t *band = nextBand();
+        for (uint32_t i = 0; i < n; i++) {
+            uint16_t p = idx[data[i]];
+            band[i] = (p >> 8) | (p << 8);
+        }
+        queueBand(n * 2);
+        data += n;
+        len -= n;
+    }
+}
+
+void LcdDmaBus::writeIndexedPixelsDouble(uint8_t *data, uint16_t *idx, uint32_t len) {
+    flushData();
+    _pixels += len * 2;
+
+    // Each index is sent twice
+    while (len > 0) {
+        uint32_t n = min(len, (uint32_t)(BAND_PIXELS / 2));
+        uint16_t *band = nextBand();
+        for (uint32_t i = 0; i < n; i++) {
+            uint16_t p = idx[data[i]];
+            band[i * 2] = band[i * 2 + 1] = (p >> 8) | (p << 8);
+        }
+        queueBand(n * 4);
+        data += n;
+        len -= n;
+    }
+}
+
+// ============== Queued rectangles ==============
+
+bool LcdDmaBus::queueRect(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *pixels,
+                          uint16_t stride, bool bigEndian, volatile bool *done) {
+    if (!_started || w == 0 || h == 0) return false;
+
+    Rect r = {x, y, w, h, pixels, stride, bigEndian, done};
+    if (done) *done = false;
+
+    // While the task is idle the bands are ours: finish any synchronous
+    // writes so it starts on a clean bus
+    portENTER_CRITICAL(&_mux);
+    bool idle = (_rectsPending == 0);
+    _rectsPending++;
+    portEXIT_CRITICAL(&_mux);
+    if (idle) {
+        flushData();
+        waitBands();
+    }
+
+    // Only this task queues, so a full queue stays full until the flush
+    // task takes one; waiting here would stall the frame instead
+    if (xQueueSend(_rects, &r, 0) != pdTRUE) {
+        portENTER_CRITICAL(&_mux);
+        _rectsPending--;
+        portEXIT_CRITICAL(&_mux);
+        if (done) *done = true;
+        return false;
+    }
+    _pixels += (uint32_t)w * h;
+    return true;
+}
+
+void LcdDmaBus::waitIdle() {
+    while (_rectsPending > 0) vTaskDelay(1);
+}
+
+void LcdDmaBus::writeWindow(int16_t x, int16_t y, uint16_t w, uint16_t h) {
+    uint8_t win[4];
+
+    writeCommand(CMD_CASET);
+    win[0] = x >> 8; win[1] = x; win[2] = (x + w - 1) >> 8; win[3] = x + w - 1;
+    sendBytes(win, 4, true);
+    writeCommand(CMD_RASET);
+    win[0] = y >> 8; win[1] = y; win[2] = (y + h - 1) >> 8; win[3] = y + h - 1;
+    sendBytes(win, 4, true);
+    writeCommand(CMD_RAMWR);
+}
+
+void LcdDmaBus::sendRect(const Rect *r) {
+    writeWindow(r->x, r->y, r->w, r->h);
+
+    // Whole rows per band, so each band is one contiguous transfer
+    uint16_t rowsPerBand = max(1, BAND_PIXELS / (int)r->w);
+    for (uint16_t row = 0; row < r->h; row += rowsPerBand) {
+        uint16_t rows = min((uint16_t)(r->h - row), rowsPerBand);
+        uint16_t *band = nextBand();
+        uint16_t *out = band;
+
+        for (uint16_t j = 0; j < rows; j++) {
+            const uint16_t *src = r->pixels + (uint32_t)(row + j) * r->stride;
+            if (r->bigEndian) {
+                memcpy(out, src, r->w * 2);
+            } else {
+                for (uint16_t i = 0; i < r->w; i++) out[i] = (src[i] >> 8) | (src[i] << 8);
+            }
+            out += r->w;
+        }
+        queueBand((uint32_t)rows * r->w * 2);
+    }
+    waitBands();
+}
+
+void LcdDmaBus::flushTask(void *arg) {
+    LcdDmaBus *bus = (LcdDmaBus *)arg;
+    Rect r;
+
+    while (true) {
+        if (xQueueReceive(bus->_rects, &r, portMAX_DELAY) != pdTRUE) continue;
+
+        bus->sendRect(&r);
+        if (r.done) *r.done = true;
+
+        portENTER_CRITICAL(&bus->_mux);
+        bus->_rectsPending--;
+        portEXIT_CRITICAL(&bus->_mux);
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef LCDBUS_H
+#define LCDBUS_H
+
+#include <Arduino.h>
+#include <Arduino_GFX_Library.h>
+#include <driver/spi_master.h>
+#include <freertos/queue.h>
+#include "config.h"
+
+// SPI data bus for the ST7789 on the ESP-IDF spi_master driver with DMA.
+//
+// Pixel data goes out through two line bands: one is filled (byte-swapped
+// into panel order) while the other is transferred, and the last band is
+// left in flight when the call returns. Commands and small writes are
+// collected in a short buffer and sent as polling transactions.
+//
+// Rectangles can also be queued whole with queueRect(); a flush task sets
+// the address window and streams them while the caller carries on. Any
+// synchronous use of the bus (beginWrite()) waits for queued rectangles.
+// Queuing never blocks: with LCD_DMA_QUEUE_LEN rectangles outstanding it
+// fails and the caller keeps its changes for a later frame.
+
+class LcdDmaBus : public Arduino_DataBus {
+public:
+    LcdDmaBus(int8_t dc, int8_t cs, int8_t sck, int8_t mosi);
+
+    bool begin(int32_t speed = GFX_NOT_DEFINED, int8_t dataMode = GFX_NOT_DEFINED) override;
+    void beginWrite() override;
+    void endWrite() override;
+    void writeCommand(uint8_t c) override;
+    void writeCommand16(uint16_t c) override;
+    void writeCommandBytes(uint8_t *data, uint32_t len) override;
+    void write(uint8_t d) override;
+    void write16(uint16_t d) override;
+    void writeRepeat(uint16_t p, uint32_t len) override;
+    void writePixels(uint16_t *data, uint32_t len) override;
+    void writeBytes(uint8_t *data, uint32_t len) override;
+    void writeIndexedPixels(uint8_t *data, uint16_t *idx, uint32_t len) override;
+    void writeIndexedPixelsDouble(uint8_t *data, uint16_t *idx, uint32_t len) override;
+
+    // Set the address window (panel coordinates) and start a memory write;
+    // pixel writes that follow fill it
+    void writeWindow(int16_t x, int16_t y, uint16_t w, uint16_t h);
+
+    // Queue a w x h rectangle at panel coordinates x, y. Rows are stride
+    // pixels apart; bigEndian pixels are already in panel byte order.
+    // pixels must stay untouched until *done is set (done may be null).
+    // Returns false, with *done set and nothing sent, when the queue is full.
+    bool queueRect(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *pixels,
+                   uint16_t stride, bool bigEndian, volatile bool *done);
+
+    // Rectangles queueRect() would take right now
+    uint8_t queueSpace() const { return _rects ? uxQueueSpacesAvailable(_rects) : 0; }
+
+    // Block until every queued rectangle is on the panel
+    void waitIdle();
+
+    // Bytes sent since begin() (commands, parameters and pixels)
+    uint32_t bytesSent() const { return _bytes; }
+
+    // Pixels written or queued since begin()
+    uint32_t pixelsSent() const { return _pixels; }
+
+private:
+    typedef struct {
+        int16_t x, y;
+        uint16_t w, h;
+        const uint16_t *pixels;
+        uint16_t stride;
+        bool bigEndian;
+        volatile bool *done;
+    } Rect;
+
+    static void flushTask(void *arg);
+
+    void sendBytes(const uint8_t *data, uint32_t len, bool dc);
+    void flushData();
+    uint16_t *nextBand();
+    void queueBand(uint32_t bytes);
+    void waitBands();
+    void sendRect(const Rect *r);
+
+    int8_t _dc, _cs, _sck, _mosi;
+    bool _started = false;
+    spi_device_handle_t _dev = nullptr;
+
+    // Line bands (DMA-capable) and their transactions
+    uint16_t *_band[2] = {nullptr, nullptr};
+    spi_transaction_t _trans[2];
+    bool _inFlight[2] = {false, false};
+    uint8_t _bandNext = 0;
+
+    // Pending command parameters / small data writes
+    uint8_t *_data = nullptr;
+    uint16_t _dataLen = 0;
+
+    // Rectangles handed to the flush task
+    QueueHandle_t _rects = nullptr;
+    volatile uint8_t _rectsPending = 0;
+    portMUX_TYPE _mux = portMUX_INITIALIZER_UNLOCKED;
+
+    volatile uint32_t _bytes = 0;
+    uint32_t _pixels = 0;
+};
+
+#endif // LCDBUS_H
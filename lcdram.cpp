@@ -0,0 +1,265 @@
+#include "lcdram.h"
+
+// MIPI DCS window commands
+#define CMD_CASET 0x2A
+#define CMD_RASET 0x2B
+#define CMD_RAMWR 0x2C
+
+LcdRamBus::LcdRamBus(uint16_t width, uint16_t height)
+    : _width(width), _height(height) {
+}
+
+bool LcdRamBus::begin(int32_t speed, int8_t dataMode) {
+    // The display is set up twice (full panel, then the visible area)
+    if (_fb) return true;
+
+    _fb = (uint16_t *)calloc((size_t)_width * _height, sizeof(uint16_t));
+    if (!_fb) {
+        Serial.println("LCD: RAM framebuffer allocation failed");
+        return false;
+    }
+    _x1 = _width - 1;
+    _y1 = _height - 1;
+    return true;
+}
+
+// ============== Command decoding ==============
+
+void LcdRamBus::writeCommand(uint8_t c) {
+    _cmd = c;
+    _argc = 0;
+    _haveHigh = false;
+    if (c == CMD_RAMWR) {
+        _cx = _x0;
+        _cy = _y0;
+    }
+    _bytes++;
+}
+
+void LcdRamBus::writeCommand16(uint16_t c) {
+    writeCommand((uint8_t)c);
+    _bytes++;
+}
+
+void LcdRamBus::writeCommandBytes(uint8_t *data, uint32_t len) {
+    while (len--) writeCommand(*data++);
+}
+
+void LcdRamBus::write(uint8_t d) {
+    if (_cmd == CMD_RAMWR) {
+        // Pixels arrive high byte first; putPixel() counts both bytes
+        if (!_haveHigh) {
+            _high = d;
+            _haveHigh = true;
+        } else {
+            _haveHigh = false;
+            putPixel((uint16_t)(_high << 8) | d);
+        }
+        return;
+    }
+
+    _bytes++;
+
+    if (_cmd != CMD_CASET && _cmd != CMD_RASET) return;
+    if (_argc < 4) _args[_argc++] = d;
+    if (_argc == 4) {
+        int16_t lo = (_args[0] << 8) | _args[1];
+        int16_t hi = (_args[2] << 8) | _args[3];
+        if (_cmd == CMD_CASET) {
+            _x0 = lo;
+            _x1 = hi;
+        } else {
+            _y0 = lo;
+            _y1 = hi;
+        }
+    }
+}
+
+void LcdRamBus::write16(uint16_t d) {
+    write(d >> 8);
+    write(d);
+}
+
+void LcdRamBus::writeBytes(uint8_t *data, uint32_t len) {
+    while (len--) write(*data++);
+}
+
+// ============== Pixels ==============
+
+void LcdRamBus::putPixel(uint16_t p) {
+    _bytes += 2;
+    _pixels++;
+
+    if (_cy > _y1) return;   // Past the window; the panel drops it too
+    if (_fb && _cx >= 0 && _cx < _width && _cy >= 0 && _cy < _height) {
+        _fb[(uint32_t)_cy * _width + _cx] = p;
+    }
+    if (++_cx > _x1) {
+        _cx = _x0;
+        _cy++;
+    }
+}
+
+void LcdRamBus::writeRepeat(uint16_t p, uint32_t len) {
+    while (len--) putPixel(p);
+}
+
+void LcdRamBus::writePixels(uint16_t *data, uint32_t len) {
+    while (len--) putPixel(*data++);
+}
+
+void LcdRamBus::writeIndexedPixels(uint8_t *data, uint16_t *idx, uint32_t len) {
+    while (len--) putPixel(idx[*data++]);
+}
+
+void LcdRamBus::writeIndexedPixelsDouble(uint8_t *data, uint16_t *idx, uint32_t len) {
+    while (len--) {
+        uint16_t p = idx[*data++];
+        putPixel(p);
+        putPixel(p);
+    }
+}
+
+void LcdRamBus::writeWindow(int16_t x, int16_t y, uint16_t w, uint16_t h) {
+    writeCommand(CMD_CASET);
+    write16(x);
+    write16(x + w - 1);
+    writeCommand(CMD_RASET);
+    write16(y);
+    write16(y + h - 1);
+    writeCommand(CMD_RAMWR);
+}
+
+bool LcdRamBus::queueRect(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *pixels,
+                          uint16_t stride, bool bigEndian, volatile bool *done) {
+    if (!_fb || w == 0 || h == 0) return false;
+
+    writeWindow(x, y, w, h);
+    for (uint16_t row = 0; row < h; row++) {
+        const uint16_t *src = pixels + (uint32_t)row * stride;
+        for (uint16_t i = 0; i < w; i++) {
+            uint16_t p = src[i];
+            putPixel(bigEndian ? (uint16_t)((p >> 8) | (p << 8)) : p);
+        }
+    }
+    if (done) *done = true;
+    return true;
+}
+
+uint16_t LcdRamBus::pixel(int16_t x, int16_t y) const {
+    if (!_fb || x < 0 || x >= _width || y < 0 || y >= _height) return 0;
+    return _fb[(uint32_t)y * _width + x];
+}
+
+// ============== PNG ==============
+
+// Chunk writer keeping the running CRC-32 of the chunk type and data
+typedef struct {
+    Print *out;
+    uint32_t crc;
+    bool ok;
+} PngChunk;
+
+static void pngBytes(PngChunk *c, const uint8_t *data, size_t len) {
+    if (c->out->write(data, len) != len) c->ok = false;
+    for (size_t i = 0; i < len; i++) {
+        c->crc ^= data[i];
+        for (uint8_t k = 0; k < 8; k++) c->crc = (c->crc >> 1) ^ (0xEDB88320UL & (0 - (c->crc & 1)));
+    }
+}
+
+static void pngBE32(uint8_t *b, uint32_t v) {
+    b[0] = v >> 24; b[1] = v >> 16; b[2] = v >> 8; b[3] = v;
+}
+
+static void pngBegin(PngChunk *c, const char *type, uint32_t len) {
+    uint8_t b[4];
+    pngBE32(b, len);
+    if (c->out->write(b, 4) != 4) c->ok = false;
+    c->crc = 0xFFFFFFFFUL;
+    pngBytes(c, (const uint8_t *)type, 4);
+}
+
+static void pngEnd(PngChunk *c) {
+    uint8_t b[4];
+    pngBE32(b, c->crc ^ 0xFFFFFFFFUL);
+    if (c->out->write(b, 4) != 4) c->ok = false;
+}
+
+bool LcdRamBus::writePng(Print &out, int16_t y, uint16_t h) const {
+    if (!_fb || y < 0 || h == 0 || y + h > _height) return false;
+
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    PngChunk c = {&out, 0, true};
+    if (out.write(signature, 8) != 8) return false;
+
+    // 8-bit RGB, no interlace
+    uint8_t ihdr[13] = {0};
+    pngBE32(ihdr, _width);
+    pngBE32(ihdr + 4, h);
+    ihdr[8] = 8;
+    ihdr[9] = 2;
+    pngBegin(&c, "IHDR", 13);
+    pngBytes(&c, ihdr, 13);
+    pngEnd(&c);
+
+    // One zlib stream of stored deflate blocks; each row is a filter byte
+    // (none) and the pixels expanded to RGB888
+    const uint32_t rowBytes = 1 + (uint32_t)_width * 3;
+    const uint32_t raw = rowBytes * h;
+    const uint32_t blocks = (raw + 65534) / 65535;
+    pngBegin(&c, "IDAT", 2 + blocks * 5 + raw + 4);
+
+    static const uint8_t zlibHeader[2] = {0x78, 0x01};
+    pngBytes(&c, zlibHeader, 2);
+
+    uint32_t adlerA = 1, adlerB = 0;
+    uint32_t blockLeft = 0, done = 0;
+    uint8_t rgb[3 * 16];
+
+    for (uint16_t row = 0; row < h; row++) {
+        const uint16_t *src = _fb + (uint32_t)(y + row) * _width;
+        for (int32_t i = -1; i < (int32_t)_width;) {
+            // Row bytes in groups that never straddle a block header
+            uint8_t n = 0;
+            if (i < 0) {
+                rgb[n++] = 0;
+                i++;
+            }
+            while (i < (int32_t)_width && n + 3 <= (int)sizeof(rgb)) {
+                uint16_t p = src[i++];
+                rgb[n++] = ((p >> 11) * 527 + 23) >> 6;
+                rgb[n++] = (((p >> 5) & 0x3F) * 259 + 33) >> 6;
+                rgb[n++] = ((p & 0x1F) * 527 + 23) >> 6;
+            }
+
+            for (uint8_t k = 0; k < n;) {
+                if (blockLeft == 0) {
+                    blockLeft = min(raw - done, (uint32_t)65535);
+                    uint8_t hdr[5] = {(uint8_t)(done + blockLeft == raw), (uint8_t)blockLeft,
+                                      (uint8_t)(blockLeft >> 8), (uint8_t)~blockLeft,
+                                      (uint8_t)(~blockLeft >> 8)};
+                    pngBytes(&c, hdr, 5);
+                }
+                uint8_t m = (uint8_t)min((uint32_t)(n - k), blockLeft);
+                pngBytes(&c, rgb + k, m);
+                for (uint8_t j = 0; j < m; j++) {
+                    adlerA = (adlerA + rgb[k + j]) % 65521;
+                    adlerB = (adlerB + adlerA) % 65521;
+                }
+                k += m;
+                blockLeft -= m;
+                done += m;
+            }
+        }
+    }
+
+    uint8_t adler[4];
+    pngBE32(adler, (adlerB << 16) | adlerA);
+    pngBytes(&c, adler, 4);
+    pngEnd(&c);
+
+    pngBegin(&c, "IEND", 0);
+    pngEnd(&c);
+    return c.ok;
+}
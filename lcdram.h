@@ -0,0 +1,75 @@
+#ifndef LCDRAM_H
+#define LCDRAM_H
+
+#include <Arduino.h>
+#include <Arduino_GFX_Library.h>
+#include "config.h"
+
+// ST7789 stand-in that keeps the panel memory in RAM.
+//
+// Takes the place of LcdDmaBus (same queueRect/writeWindow/waitIdle
+// interface) and decodes the command stream the driver sends: CASET and
+// RASET set the address window, RAMWR starts filling it, everything else is
+// counted and ignored. Bytes and pixels are counted as they would cross the
+// SPI bus, so a frame's cost can be measured without the panel, and the
+// memory can be written out as a PNG. It is still an Arduino_DataBus and
+// uses Arduino's Print, so it builds with the sketch or, for the host
+// display tests, against the stand-ins in test/stubs.
+
+class LcdRamBus : public Arduino_DataBus {
+public:
+    // Panel memory size (the ST7789 has 240 x 320 whatever is visible)
+    LcdRamBus(uint16_t width = 240, uint16_t height = 320);
+
+    bool begin(int32_t speed = GFX_NOT_DEFINED, int8_t dataMode = GFX_NOT_DEFINED) override;
+    void beginWrite() override {}
+    void endWrite() override {}
+    void writeCommand(uint8_t c) override;
+    void writeCommand16(uint16_t c) override;
+    void writeCommandBytes(uint8_t *data, uint32_t len) override;
+    void write(uint8_t d) override;
+    void write16(uint16_t d) override;
+    void writeRepeat(uint16_t p, uint32_t len) override;
+    void writePixels(uint16_t *data, uint32_t len) override;
+    void writeBytes(uint8_t *data, uint32_t len) override;
+    void writeIndexedPixels(uint8_t *data, uint16_t *idx, uint32_t len) override;
+    void writeIndexedPixelsDouble(uint8_t *data, uint16_t *idx, uint32_t len) override;
+
+    void writeWindow(int16_t x, int16_t y, uint16_t w, uint16_t h);
+
+    // Copied straight into panel memory; *done is set before returning
+    bool queueRect(int16_t x, int16_t y, uint16_t w, uint16_t h, const uint16_t *pixels,
+                   uint16_t stride, bool bigEndian, volatile bool *done);
+    uint8_t queueSpace() const { return 255; }
+    void waitIdle() {}
+
+    uint32_t bytesSent() const { return _bytes; }
+    uint32_t pixelsSent() const { return _pixels; }
+
+    // Panel memory, row-major RGB565 (native endian), or null before begin()
+    const uint16_t *framebuffer() const { return _fb; }
+    uint16_t pixel(int16_t x, int16_t y) const;
+
+    // Write rows y .. y + h - 1 as an RGB PNG (stored, not compressed)
+    bool writePng(Print &out, int16_t y, uint16_t h) const;
+
+private:
+    void putPixel(uint16_t p);
+
+    uint16_t _width, _height;
+    uint16_t *_fb = nullptr;
+
+    // Command decoding
+    uint8_t _cmd = 0;
+    uint8_t _args[4];
+    uint8_t _argc = 0;
+    int16_t _x0 = 0, _x1 = 0, _y0 = 0, _y1 = 0;   // Address window
+    int16_t _cx = 0, _cy = 0;                     // Next pixel of the memory write
+    bool _haveHigh = false;                       // First byte of a pixel seen
+    uint8_t _high = 0;
+
+    uint32_t _bytes = 0;
+    uint32_t _pixels = 0;
+};
+
+#endif // LCDRAM_H
@@ -76,8 +76,9 @@ void powerEnterLightSleep() {
     // Turn off display
     displaySleep();
 
-    // Play power-off sound
+    // Play power-off sound (it plays in the background; let it finish)
     playPowerOffSound();
+    soundWaitIdle(500);
     
     Serial.println("Entering light sleep... (press button to wake)");
     Serial.flush();
@@ -0,0 +1,172 @@
+#include "proto.h"
+#include <string.h>
+
+#define LZ_WINDOW     4096
+#define LZ_MIN_MATCH  3
+#define LZ_MAX_MATCH  (LZ_MIN_MATCH + 15)
+#define LZ_HASH_BITS  8
+
+uint16_t protoCrc16(const uint8_t* data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    while (len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+size_t protoEncode(uint8_t type, uint16_t seq, const uint8_t* payload, size_t len,
+                   uint8_t* out, size_t cap, bool tryLz) {
+    if (len > PROTO_MAX_PAYLOAD || cap < PROTO_OVERHEAD) return 0;
+
+    size_t room = cap - PROTO_OVERHEAD;
+    size_t n = 0;
+    type &= PROTO_TYPE_MASK;
+
+    if (tryLz && len > 0) {
+        n = protoCompress(payload, len, out + PROTO_HEADER, room);
+    }
+    if (n > 0) {
+        type |= PROTO_FLAG_LZ;
+    } else {
+        if (len > room) return 0;
+        if (len > 0) memcpy(out + PROTO_HEADER, payload, len);
+        n = len;
+    }
+
+    out[0] = PROTO_MAGIC;
+    out[1] = type;
+    protoPut16(out + 2, (uint16_t)n);
+    protoPut16(out + 4, seq);
+    protoPut16(out + PROTO_HEADER + n, protoCrc16(out + 1, PROTO_HEADER - 1 + n));
+    return n + PROTO_OVERHEAD;
+}
+
+int protoDecode(const uint8_t* buf, size_t len, ProtoFrame* frame) {
+    if (len == 0) return PROTO_DECODE_SHORT;
+    if (buf[0] != PROTO_MAGIC) return PROTO_DECODE_MAGIC;
+    if (len < PROTO_OVERHEAD) return PROTO_DECODE_SHORT;
+
+    uint16_t n = protoGet16(buf + 2);
+    if (n > PROTO_MAX_PAYLOAD) return PROTO_DECODE_LEN;
+    if (len < (size_t)n + PROTO_OVERHEAD) return PROTO_DECODE_SHORT;
+
+    if (protoGet16(buf + PROTO_HEADER + n) != protoCrc16(buf + 1, PROTO_HEADER - 1 + n)) {
+        return PROTO_DECODE_CRC;
+    }
+
+    frame->type = buf[1] & PROTO_TYPE_MASK;
+    frame->compressed = (buf[1] & PROTO_FLAG_LZ) != 0;
+    frame->seq = protoGet16(buf + 4);
+    frame->payload = buf + PROTO_HEADER;
+    frame->len = n;
+    frame->frameLen = (size_t)n + PROTO_OVERHEAD;
+    return PROTO_DECODE_OK;
+}
+
+static inline uint8_t lzHash(const uint8_t* p) {
+    return (uint8_t)((p[0] * 33u ^ p[1] * 7u ^ p[2]) & ((1 << LZ_HASH_BITS) - 1));
+}
+
+size_t protoCompress(const uint8_t* in, size_t len, uint8_t* out, size_t cap) {
+    if (len > PROTO_MAX_PAYLOAD) return 0;
+
+    // Last position seen for each hash; payloads are small enough for int16
+    int16_t head[1 << LZ_HASH_BITS];
+    memset(head, 0xFF, sizeof(head));
+
+    size_t i = 0, o = 0;
+    size_t flagPos = 0;
+    int bit = 8;
+
+    while (i < len) {
+        if (bit == 8) {
+            if (o >= cap) return 0;
+            flagPos = o++;
+            out[flagPos] = 0;
+            bit = 0;
+        }
+
+        size_t best = 0, dist = 0;
+        if (i + LZ_MIN_MATCH <= len) {
+            uint8_t h = lzHash(in + i);
+            int16_t cand = head[h];
+            head[h] = (int16_t)i;
+            if (cand >= 0 && i - cand <= LZ_WINDOW) {
+                size_t max = len - i;
+                if (max > LZ_MAX_MATCH) max = LZ_MAX_MATCH;
+                while (best < max && in[cand + best] == in[i + best]) best++;
+                dist = i - cand;
+            }
+        }
+
+        if (best >= LZ_MIN_MATCH) {
+            if (o + 2 > cap) return 0;
+            out[flagPos] |= 1 << bit;
+            out[o++] = (uint8_t)(((dist - 1) >> 8) << 4 | (best - LZ_MIN_MATCH));
+            out[o++] = (uint8_t)(dist - 1);
+            for (size_t k = 1; k < best; k++) {
+                if (i + k + LZ_MIN_MATCH <= len) head[lzHash(in + i + k)] = (int16_t)(i + k);
+            }
+            i += best;
+        } else {
+            if (o >= cap) return 0;
+            out[o++] = in[i++];
+        }
+        bit++;
+    }
+
+    return o < len ? o : 0;
+}
+
+size_t protoDecompress(const uint8_t* in, size_t len, uint8_t* out, size_t cap) {
+    size_t i = 0, o = 0;
+
+    while (i < len) {
+        uint8_t flags = in[i++];
+        for (int bit = 0; bit < 8 && i < len; bit++) {
+            if (flags & (1 << bit)) {
+                if (i + 2 > len) return 0;
+                size_t n = (in[i] & 0x0F) + LZ_MIN_MATCH;
+                size_t dist = (((size_t)(in[i] >> 4) << 8) | in[i + 1]) + 1;
+                i += 2;
+                if (dist > o || n > cap - o) return 0;
+                // Byte by byte: matches may overlap their own output
+                for (size_t k = 0; k < n; k++, o++) out[o] = out[o - dist];
+            } else {
+                if (o >= cap) return 0;
+                out[o++] = in[i++];
+            }
+        }
+    }
+
+    return o;
+}
+
+void protoAdvEncode(const ProtoAdv* adv, uint8_t* out) {
+    protoPut16(out, adv->companyId);
+    out[2] = PROTO_ADV_FORMAT;
+    protoPut32(out + 3, adv->deviceId);
+    out[7] = adv->counter;
+    out[8] = adv->flags;
+    out[9] = adv->battery;
+    protoPut16(out + 10, adv->reps);
+    protoPut16(out + 12, adv->peakMmS);
+    protoPut16(out + 14, adv->meanMmS);
+}
+
+bool protoAdvDecode(const uint8_t* data, size_t len, ProtoAdv* adv) {
+    if (len < PROTO_ADV_LEN || data[2] != PROTO_ADV_FORMAT) return false;
+
+    adv->companyId = protoGet16(data);
+    adv->deviceId = protoGet32(data + 3);
+    adv->counter = data[7];
+    adv->flags = data[8];
+    adv->battery = data[9];
+    adv->reps = protoGet16(data + 10);
+    adv->peakMmS = protoGet16(data + 12);
+    adv->meanMmS = protoGet16(data + 14);
+    return true;
+}
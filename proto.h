@@ -0,0 +1,145 @@
+#ifndef PROTO_H
+#define PROTO_H
+
+// Binary framing for the BLE UART service.
+// Plain C/C++ with no Arduino dependencies, so the phone app or a host tool
+// can build this file as is and share the codec with the firmware.
+//
+// Frame layout (all multi-byte fields little-endian):
+//   [0]     PROTO_MAGIC
+//   [1]     type (PROTO_FLAG_LZ set when the payload is compressed)
+//   [2..3]  payload length (as sent, after compression)
+//   [4..5]  frame sequence number, +1 per frame in each direction
+//   [6..]   payload
+//   [n..]   CRC16-CCITT (poly 0x1021, init 0xFFFF) over type..payload
+//
+// A frame may span several notifications/writes; the receiver reassembles
+// by length. Sequence gaps or CRC errors mean a lost or damaged chunk.
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define PROTO_MAGIC        0xA5
+#define PROTO_VERSION      1
+#define PROTO_HEADER       6
+#define PROTO_OVERHEAD     (PROTO_HEADER + 2)
+#define PROTO_MAX_PAYLOAD  1024
+#define PROTO_FLAG_LZ      0x80
+#define PROTO_TYPE_MASK    0x7F
+
+// Command set. Requests come from the phone, the rest from the device.
+enum {
+    PROTO_PING          = 0x01,  // Any payload, echoed back in PONG
+    PROTO_PONG          = 0x02,
+    PROTO_INFO_GET      = 0x03,
+    PROTO_INFO          = 0x04,  // u8 version, u8 battery %, u16 battery mV, u16 notify payload,
+                                 // u32 first/next/synced seq, u32 this phone's cursor
+
+    PROTO_SYNC          = 0x10,  // [u32 fromSeq] (empty = resume from this phone's cursor)
+    PROTO_SYNC_BEGIN    = 0x11,  // u32 fromSeq, u32 endSeq
+    PROTO_SYNC_DATA     = 0x12,  // "seq,<csv row>\n" lines (first one is the header)
+    PROTO_SYNC_END      = 0x13,  // u32 endSeq
+    PROTO_ACK           = 0x14,  // u32 seq: every row below seq is stored on the phone
+
+    // Live telemetry goes out on its own characteristic while subscribed
+    PROTO_LIVE_SUB      = 0x20,  // u8 on: add the velocity trace to the live stream
+    PROTO_LIVE_REP      = 0x21,  // u16 rep, u16 duration ms, u16 peak mm/s, u16 mean mm/s,
+                                 // u32 rep end (ms since set start)
+    PROTO_LIVE_TRACE    = 0x22,  // u16 first sample index, u8 rate Hz, int16 mm/s samples
+
+    PROTO_SETTINGS_GET  = 0x30,
+    PROTO_SETTINGS      = 0x31,  // u8 sensitivity (1-100), u8 volume (0-100)
+    PROTO_SETTINGS_SET  = 0x32,  // Same layout as PROTO_SETTINGS
+
+    PROTO_STATUS        = 0x7F   // u8 request type, u8 status code
+};
+
+// Status codes carried by PROTO_STATUS
+enum {
+    PROTO_OK = 0,
+    PROTO_ERR_FRAME,     // Bad CRC, length or magic
+    PROTO_ERR_UNKNOWN,   // Unknown command
+    PROTO_ERR_ARG,       // Malformed payload
+    PROTO_ERR_BUSY,      // A sync is already running
+    PROTO_ERR_NO_DATA    // Nothing to sync
+};
+
+// protoDecode() results
+enum {
+    PROTO_DECODE_OK = 0,
+    PROTO_DECODE_SHORT,  // Need more bytes
+    PROTO_DECODE_MAGIC,
+    PROTO_DECODE_LEN,
+    PROTO_DECODE_CRC
+};
+
+typedef struct {
+    uint8_t type;            // Without PROTO_FLAG_LZ
+    bool compressed;
+    uint16_t seq;
+    const uint8_t* payload;  // Points into the decoded buffer
+    uint16_t len;
+    size_t frameLen;         // Bytes consumed from the buffer
+} ProtoFrame;
+
+uint16_t protoCrc16(const uint8_t* data, size_t len);
+
+// Build a frame into out. With tryLz the payload is compressed when that
+// makes it smaller. Returns the frame length, 0 if it doesn't fit in cap.
+size_t protoEncode(uint8_t type, uint16_t seq, const uint8_t* payload, size_t len,
+                   uint8_t* out, size_t cap, bool tryLz);
+
+// Parse one frame from the start of buf. Safe on arbitrary input.
+int protoDecode(const uint8_t* buf, size_t len, ProtoFrame* frame);
+
+// LZSS with a 4 KB window: groups of 8 items behind a flag byte (bit set =
+// 2-byte match of 12-bit distance and 4-bit length, clear = literal).
+// Both return the output length, or 0 when the result won't fit in cap
+// (or for compression, when it wouldn't be smaller than the input).
+size_t protoCompress(const uint8_t* in, size_t len, uint8_t* out, size_t cap);
+size_t protoDecompress(const uint8_t* in, size_t len, uint8_t* out, size_t cap);
+
+// Advertising summary: manufacturer data a hub reads without connecting.
+//   u16 company ID, u8 format (PROTO_ADV_FORMAT), u32 device ID, u8 change
+//   counter, u8 flags, u8 battery %, u16 reps in set, u16 last rep peak mm/s,
+//   u16 last rep mean mm/s
+// The counter moves whenever anything else does, so a scanner can drop
+// repeated reports by comparing it alone.
+#define PROTO_ADV_LEN     16
+#define PROTO_ADV_FORMAT  1
+
+enum {
+    PROTO_ADV_RUNNING    = 0x01,  // Workout running
+    PROTO_ADV_SET_ACTIVE = 0x02,
+    PROTO_ADV_CHARGING   = 0x04,
+    PROTO_ADV_UNSYNCED   = 0x08   // Log rows no phone has acknowledged
+};
+
+typedef struct {
+    uint16_t companyId;
+    uint32_t deviceId;
+    uint8_t counter;
+    uint8_t flags;
+    uint8_t battery;
+    uint16_t reps;
+    uint16_t peakMmS;
+    uint16_t meanMmS;
+} ProtoAdv;
+
+void protoAdvEncode(const ProtoAdv* adv, uint8_t* out);   // PROTO_ADV_LEN bytes
+
+// False unless data is a PROTO_ADV_FORMAT summary of at least PROTO_ADV_LEN
+// bytes (longer is fine: later formats only append)
+bool protoAdvDecode(const uint8_t* data, size_t len, ProtoAdv* adv);
+
+// Little-endian field helpers
+static inline void protoPut16(uint8_t* p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+static inline void protoPut32(uint8_t* p, uint32_t v) {
+    p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+static inline uint16_t protoGet16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static inline uint32_t protoGet32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+#endif // PROTO_H
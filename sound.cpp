@@ -5,6 +5,10 @@
 #include "Wire.h"
 #include "es8311.h"
 #include "config.h"
+#include "synth.h"
+#include "cues.h"
+#include <freertos/queue.h>
+#include <freertos/task.h>
 
 static const char *TAG = "audio";
 static uint8_t volume = AUDIO_VOLUME;
@@ -34,6 +38,22 @@ void setVolume(uint8_t _volume) {
 }
 
 static esp_err_t es8311_codec_init(void) {
+  uint32_t start = micros();
+  uint32_t reads0 = 0, writes0 = 0;
+
+  // After light sleep the codec keeps (or has lost) the state we gave it;
+  // the register shadow puts back what is missing without a full init
+  if (es_handle) {
+    es8311_i2c_counts(es_handle, &reads0, &writes0);
+    esp_err_t err = es8311_restore(es_handle);
+    uint32_t reads, writes;
+    es8311_i2c_counts(es_handle, &reads, &writes);
+    Serial.printf("Audio: codec restored in %lu us (%lu I2C reads, %lu writes)\n",
+                  (unsigned long)(micros() - start), (unsigned long)(reads - reads0),
+                  (unsigned long)(writes - writes0));
+    return err;
+  }
+
   es_handle = es8311_create(I2C_NUM_0, ES8311_ADDRRES_0);
   ESP_RETURN_ON_FALSE(es_handle, ESP_FAIL, TAG, "es8311 create failed");
 
@@ -46,81 +66,333 @@ static esp_err_t es8311_codec_init(void) {
   };
 
   ESP_ERROR_CHECK(es8311_init(es_handle, &es_clk, ES8311_RESOLUTION_16, ES8311_RESOLUTION_16));
-  ESP_RETURN_ON_ERROR(es8311_voice_volume_set(es_handle, volume, NULL), TAG, "set volume failed");
-  ESP_RETURN_ON_ERROR(es8311_microphone_config(es_handle, false), TAG, "mic config failed");
-
+  es8311_batch_begin(es_handle);
+  es8311_voice_volume_set(es_handle, volume, NULL);
+  es8311_microphone_config(es_handle, false);
+  ESP_RETURN_ON_ERROR(es8311_batch_commit(es_handle), TAG, "volume/mic config failed");
+
+  uint32_t reads, writes;
+  es8311_i2c_counts(es_handle, &reads, &writes);
+  Serial.printf("Audio: codec init in %lu us (%lu I2C reads, %lu writes)\n",
+                (unsigned long)(micros() - start), (unsigned long)reads, (unsigned long)writes);
   return ESP_OK;
 }
 
-// ---------------- Simple synth helpers ----------------
-static inline void writeSilenceMs(uint32_t ms) {
-  const uint32_t total = (uint64_t)AUDIO_SAMPLE_RATE * ms / 1000;
-  const int CHUNK = 256;
-  int16_t buf[CHUNK];
-  memset(buf, 0, sizeof(buf));
+// ---------------- Engine ----------------
+// Cues are queued by ID and played by a task that keeps the I2S DMA
+// buffers filled, so triggering one only costs a queue send. A newer cue
+// preempts the one playing, which fades out over AUDIO_FADE_MS first.
+// With AUDIO_CUE_CACHE the task streams the cue pre-rendered at compile
+// time (cues.h); otherwise it synthesizes the notes as it goes. Rep tones
+// have a pitch only known at run time and always go through the synth.
+
+typedef struct {
+  uint8_t cue;          // SoundCue, or SOUND_CUE_COUNT for a tone
+  uint16_t freq;        // Tone only
+  uint32_t triggerUs;   // micros() of the event that asked for it
+} SoundMsg;
+
+static synth::Bank bank;   // Voices, owned by the audio task
+static QueueHandle_t cueQueue = nullptr;
+static volatile uint8_t cuesPending = 0;   // Queued or playing
+static portMUX_TYPE cueMux = portMUX_INITIALIZER_UNLOCKED;
+static AudioStats stats;
+static uint32_t cueCpuUs = 0;              // Render/decode time of the sound playing
+static uint32_t latencyFromUs = 0;         // Trigger time until its first samples go out
+
+static void cueDone() {
+  portENTER_CRITICAL(&cueMux);
+  cuesPending--;
+  portEXIT_CRITICAL(&cueMux);
+}
 
-  uint32_t remaining = total;
-  while (remaining) {
-    uint32_t n = remaining > CHUNK ? CHUNK : remaining;
-    i2s.write((uint8_t*)buf, n * 2);
-    remaining -= n;
+// Newest sound waiting, if any (older ones are skipped)
+static bool takeCue(SoundMsg *msg, TickType_t wait) {
+  if (xQueueReceive(cueQueue, msg, wait) != pdTRUE) return false;
+  while (xQueueReceive(cueQueue, msg, 0) == pdTRUE) {
+    stats.skipped++;
+    cueDone();
   }
+  return true;
 }
 
-// Sine tone with tiny attack/release to avoid clicks
-static void playToneHz(uint16_t freq, uint32_t ms, int16_t amp = 11000, uint32_t attackMs = 5, uint32_t releaseMs = 8) {
-  // Skip if muted
-  if (volume == 0) return;
+// Hand samples to I2S; the first ones of a sound close its latency window
+static void sendSamples(int16_t *buf, uint32_t n) {
+  if (latencyFromUs) {
+    uint32_t us = micros() - latencyFromUs;
+    stats.lastLatencyUs = us;
+    if (us > stats.maxLatencyUs) stats.maxLatencyUs = us;
+    latencyFromUs = 0;
+  }
+  i2s.write((uint8_t*)buf, n * 2);
+}
 
-  const uint32_t total = (uint64_t)AUDIO_SAMPLE_RATE * ms / 1000;
-  if (total == 0) return;
+// Play the voices out. Returns true if a new sound came in.
+static bool renderVoices(int16_t *buf, SoundMsg *next) {
+  while (synth::active(bank)) {
+    if (takeCue(next, 0)) return true;
 
-  const uint32_t attackS = (uint64_t)AUDIO_SAMPLE_RATE * attackMs / 1000;
-  const uint32_t releaseS = (uint64_t)AUDIO_SAMPLE_RATE * releaseMs / 1000;
+    unsigned long startUs = micros();
+    uint32_t n = synth::render(bank, buf, SYNTH_CHUNK);
+    cueCpuUs += micros() - startUs;
+    sendSamples(buf, n);
+  }
+  return false;
+}
 
-  const int CHUNK = 256;
-  int16_t buf[CHUNK];
+// Fade out what is still sounding (a sound cut short)
+static void fadeVoices(int16_t *buf) {
+  synth::release(bank, AUDIO_FADE_MS);
+  while (synth::active(bank)) {
+    uint32_t n = synth::render(bank, buf, SYNTH_CHUNK);
+    sendSamples(buf, n);
+  }
+}
 
-  double phase = 0.0;
-  const double dphi = (2.0 * M_PI * (double)freq) / (double)AUDIO_SAMPLE_RATE;
+static bool playTone(uint16_t freq, int16_t *buf, SoundMsg *next) {
+  synth::start(bank, freq, SONIFY_TONE_MS, SONIFY_TONE_AMP, 3, SONIFY_TONE_MS / 2);
+  if (!renderVoices(buf, next)) return false;
+  fadeVoices(buf);
+  return true;
+}
 
-  uint32_t written = 0;
-  while (written < total) {
-    uint32_t n = (total - written) > CHUNK ? CHUNK : (total - written);
+#if AUDIO_CUE_CACHE
 
-    for (uint32_t i = 0; i < n; i++) {
-      uint32_t idx = written + i;
+typedef struct {
+  const uint8_t *data;
+  uint32_t pos, samples;
+  cues::Adpcm st;
+} CueStream;
 
-      float env = 1.0f;
-      if (attackS > 0 && idx < attackS) env = (float)idx / (float)attackS;
-      if (releaseS > 0 && idx > (total - releaseS)) {
-        float r = (float)(total - idx) / (float)releaseS;
-        if (r < env) env = r;
-      }
-      if (env < 0) env = 0;
+// Decode up to n samples; returns how many were left
+static uint32_t streamDecode(CueStream *s, int16_t *out, uint32_t n) {
+  uint32_t i = 0;
+  for (; i < n && s->pos < s->samples; i++, s->pos++) {
+    uint8_t b = s->data[s->pos >> 1];
+    out[i] = cues::decode(s->st, (s->pos & 1) ? b >> 4 : b & 0x0F);
+  }
+  return i;
+}
+
+// Play a cue to the end or until another sound arrives (returned in next)
+static bool playCue(uint8_t cue, int16_t *buf, SoundMsg *next) {
+  CueStream s = {kCueCache.data + kCueCache.offset[cue], 0, kCueCache.samples[cue], {0, 0}};
+
+  while (s.pos < s.samples) {
+    bool cut = takeCue(next, 0);
+    unsigned long startUs = micros();
+    uint32_t n;
+
+    if (cut) {
+      // Ramp what would have come next down to silence
+      n = streamDecode(&s, buf, synth::msToSamples(AUDIO_FADE_MS));
+      for (uint32_t i = 0; i < n; i++) buf[i] = (int32_t)buf[i] * (int32_t)(n - i) / (int32_t)n;
+    } else {
+      n = streamDecode(&s, buf, SYNTH_CHUNK);
+    }
+
+    cueCpuUs += micros() - startUs;
+    sendSamples(buf, n);
+    if (cut) return true;
+  }
+  return false;
+}
+
+#else
+
+// Render n samples (voices or silence). Returns true if a new sound came in.
+static bool renderSamples(uint32_t n, int16_t *buf, SoundMsg *next) {
+  while (n > 0) {
+    if (takeCue(next, 0)) return true;
+
+    uint32_t len = n > SYNTH_CHUNK ? SYNTH_CHUNK : n;
+    unsigned long startUs = micros();
+    synth::render(bank, buf, len);
+    cueCpuUs += micros() - startUs;
+    sendSamples(buf, len);
+    n -= len;
+  }
+  return false;
+}
+
+// Play a cue to the end or until another sound arrives (returned in next)
+static bool playCue(uint8_t cue, int16_t *buf, SoundMsg *next) {
+  const Cue *c = &cues::kCues[cue];
+
+  for (uint8_t i = 0; i < c->count; i++) {
+    const CueNote *n = &c->notes[i];
+    cues::startNote(bank, *n);
+
+    if (renderVoices(buf, next) ||
+        renderSamples(synth::msToSamples(n->gapMs), buf, next)) {
+      fadeVoices(buf);
+      return true;
+    }
+  }
+  return false;
+}
 
-      int16_t sample = (int16_t)((float)amp * env * sin(phase));
-      buf[i] = sample;
+#endif
+
+static void audioTask(void *arg) {
+  int16_t buf[SYNTH_CHUNK];
+  SoundMsg msg;
+
+  while (true) {
+    if (!takeCue(&msg, portMAX_DELAY)) continue;
+
+    while (true) {
+      SoundMsg next;
+      bool tone = msg.cue == SOUND_CUE_COUNT;
+      bool playable = volume > 0 && (tone || msg.cue < SOUND_CUE_COUNT);
+      cueCpuUs = 0;
+      latencyFromUs = msg.triggerUs;
+
+      bool cut = playable && (tone ? playTone(msg.freq, buf, &next) : playCue(msg.cue, buf, &next));
+      if (!cut) {
+        if (playable) {
+          stats.played++;
+          stats.lastCueCpuUs = cueCpuUs;
+#if AUDIO_STATS_LOG_EVERY > 0
+          if (stats.played % AUDIO_STATS_LOG_EVERY == 0) {
+            Serial.printf("Audio: %lu played (%lu preempted), last %lu us CPU, %lu us to I2S (max %lu), "
+                          "trigger cost %lu us (max %lu)\n",
+                          (unsigned long)stats.played, (unsigned long)stats.preempted,
+                          (unsigned long)stats.lastCueCpuUs, (unsigned long)stats.lastLatencyUs,
+                          (unsigned long)stats.maxLatencyUs, (unsigned long)stats.lastTriggerUs,
+                          (unsigned long)stats.maxTriggerUs);
+          }
+#endif
+        }
+        cueDone();
+        break;
+      }
 
-      phase += dphi;
-      if (phase > 2.0 * M_PI) phase -= 2.0 * M_PI;
+      stats.preempted++;
+      cueDone();
+      msg = next;
     }
+  }
+}
+
+static void queueSound(const SoundMsg *msg) {
+  if (volume == 0 || !cueQueue) return;
+
+  unsigned long startUs = micros();
+  portENTER_CRITICAL(&cueMux);
+  cuesPending++;
+  portEXIT_CRITICAL(&cueMux);
+  if (xQueueSend(cueQueue, msg, 0) != pdTRUE) {
+    stats.dropped++;
+    cueDone();
+  }
+
+  uint32_t us = micros() - startUs;
+  stats.triggers++;
+  stats.lastTriggerUs = us;
+  if (us > stats.maxTriggerUs) stats.maxTriggerUs = us;
+}
+
+void soundPlay(SoundCue cue) {
+  SoundMsg msg = {(uint8_t)cue, 0, (uint32_t)micros()};
+  queueSound(&msg);
+}
+
+// ---------------- Sonification ----------------
+// One short tone per rep, pitched by the velocity zone of its mean
+// concentric velocity: the faster the zone, the higher the note.
+
+static bool sonification = false;
+
+// Upper bounds (mm/s) of the zones below the fastest
+static const uint16_t SONIFY_ZONE_MMS[] = {
+  500,    // Absolute strength
+  750,    // Accelerative strength
+  1000,   // Strength-speed
+  1300,   // Speed-strength
+};
+
+// C major pentatonic, one note per zone
+static const uint16_t SONIFY_ZONE_HZ[] = {523, 659, 784, 1047, 1319};
+
+bool getSonification() {
+  return sonification;
+}
+
+void setSonification(bool enabled) {
+  sonification = enabled;
+}
 
-    i2s.write((uint8_t*)buf, n * 2);
-    written += n;
+void soundRepTone(uint16_t meanMmS, uint32_t repUs) {
+  if (!sonification) return;
+
+  uint8_t zone = 0;
+  while (zone < sizeof(SONIFY_ZONE_MMS) / sizeof(SONIFY_ZONE_MMS[0]) && meanMmS >= SONIFY_ZONE_MMS[zone]) zone++;
+
+  SoundMsg msg = {SOUND_CUE_COUNT, SONIFY_ZONE_HZ[zone], repUs};
+  queueSound(&msg);
+}
+
+bool soundWaitIdle(uint32_t timeoutMs) {
+  unsigned long start = millis();
+  while (cuesPending > 0) {
+    if (millis() - start >= timeoutMs) return false;
+    vTaskDelay(1);
   }
+  return true;
 }
 
-// helper: a bell-ish hit = main tone + a soft harmonic
-static void bellHit(uint16_t f, uint32_t ms, int16_t aMain, int16_t aHarm) {
-  if (volume == 0) return;
+void audioGetStats(AudioStats* out) {
+  *out = stats;
+}
+
+#if AUDIO_BENCH_SYNTH
+// The double-precision sin() loop the wavetable replaced, for comparison
+static void legacyTone(int16_t *buf, uint32_t n, uint16_t freq, int16_t amp, uint32_t attackS, uint32_t releaseS) {
+  double phase = 0.0;
+  const double dphi = (2.0 * M_PI * (double)freq) / (double)AUDIO_SAMPLE_RATE;
+
+  for (uint32_t idx = 0; idx < n; idx++) {
+    float env = 1.0f;
+    if (attackS > 0 && idx < attackS) env = (float)idx / (float)attackS;
+    if (releaseS > 0 && idx > (n - releaseS)) {
+      float r = (float)(n - idx) / (float)releaseS;
+      if (r < env) env = r;
+    }
+    if (env < 0) env = 0;
 
-  // main
-  playToneHz(f, ms, aMain, 8, 60);
+    buf[idx] = (int16_t)((float)amp * env * sin(phase));
+    phase += dphi;
+    if (phase > 2.0 * M_PI) phase -= 2.0 * M_PI;
+  }
+}
 
-  // harmonic overlay (2x freq) quieter to prevent saturation
-  playToneHz(f * 2, ms, (int16_t)(aHarm * 0.55f), 6, 80);
+static void benchSynth() {
+  const uint32_t n = SYNTH_CHUNK;
+  int16_t buf[n];
+
+  uint32_t start = ESP.getCycleCount();
+  legacyTone(buf, n, 880, 20000, 96, 192);
+  uint32_t legacy = ESP.getCycleCount() - start;
+
+  start = ESP.getCycleCount();
+  synth::start(bank, 880, n * 1000 / AUDIO_SAMPLE_RATE, 20000, 4, 8);
+  synth::render(bank, buf, n);
+  uint32_t table = ESP.getCycleCount() - start;
+  memset(&bank, 0, sizeof(bank));
+
+  cues::Adpcm st = {0, 0};
+  start = ESP.getCycleCount();
+  for (uint32_t i = 0; i < n; i++) {
+    uint8_t b = kCueCache.data[i >> 1];
+    buf[i] = cues::decode(st, (i & 1) ? b >> 4 : b & 0x0F);
+  }
+  uint32_t adpcm = ESP.getCycleCount() - start;
+
+  Serial.printf("Synth: sin() %lu, wavetable %lu, ADPCM cache %lu cycles per sample\n",
+                (unsigned long)(legacy / n), (unsigned long)(table / n), (unsigned long)(adpcm / n));
 }
+#endif
 
 bool audioInit() {
   es8311_codec_init();
@@ -135,35 +407,41 @@ bool audioInit() {
   pinMode(PA_CTRL_PIN, OUTPUT);
   digitalWrite(PA_CTRL_PIN, volume > 0 ? HIGH : LOW);
 
+#if AUDIO_BENCH_SYNTH
+  benchSynth();
+#endif
+
+  // Called again after light sleep; the engine survives it
+  if (!cueQueue) {
+#if AUDIO_CUE_CACHE
+    uint32_t samples = 0;
+    for (int i = 0; i < SOUND_CUE_COUNT; i++) samples += kCueCache.samples[i];
+    Serial.printf("Audio: cue cache %u bytes for %lu samples (%lu as PCM, synth table %u)\n",
+                  (unsigned)sizeof(kCueCache), (unsigned long)samples,
+                  (unsigned long)samples * 2, (unsigned)sizeof(synth::kSine));
+#endif
+    cueQueue = xQueueCreate(AUDIO_CUE_QUEUE_LEN, sizeof(SoundMsg));
+    if (!cueQueue || xTaskCreate(audioTask, "audio", 4096, nullptr, 3, nullptr) != pdPASS) {
+      Serial.println("Failed to start audio task!");
+      return false;
+    }
+  }
+
   return true;
 }
 
 void playPowerOnSound() {
-  if (volume == 0) return;
-  bellHit(659, 80, 21000, 4000);     // E5 (major 3rd)
-  writeSilenceMs(40);
-  bellHit(784, 120, 21000, 4000);    // G5 (perfect 5th)
+  soundPlay(SOUND_POWER_ON);
 }
 
 void playPowerOffSound() {
-  if (volume == 0) return;
-  bellHit(659, 80, 19000, 3500);     // E5
-  writeSilenceMs(40);
-  bellHit(523, 140, 19000, 3200);    // C5 (longer tail = "settle")
+  soundPlay(SOUND_POWER_OFF);
 }
 
 void playStartWorkoutSound() {
-  if (volume == 0) return;
-  // Quick punchy double-beep: A5 → D6 (fourth interval, higher register)
-  playToneHz(880, 50, 20000, 4, 10);   // A5 - short, punchy
-  writeSilenceMs(25);
-  playToneHz(1175, 80, 21000, 4, 15);  // D6 - slightly longer
+  soundPlay(SOUND_START_WORKOUT);
 }
 
 void playStopWorkoutSound() {
-  if (volume == 0) return;
-  // Resolving drop: D6 → A5 (mirror of start)
-  playToneHz(1175, 60, 19000, 4, 12);  // D6
-  writeSilenceMs(30);
-  playToneHz(880, 140, 18000, 4, 40);  // A5 - longer decay = "finished"
+  soundPlay(SOUND_STOP_WORKOUT);
 }
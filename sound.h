@@ -3,9 +3,47 @@
 
 #include <Arduino.h>
 
+// Cues are played by a background task; the play functions only queue
+// them and return within microseconds. A new cue cuts the current one short.
+typedef enum {
+  SOUND_POWER_ON,
+  SOUND_POWER_OFF,
+  SOUND_START_WORKOUT,
+  SOUND_STOP_WORKOUT,
+  SOUND_CUE_COUNT
+} SoundCue;
+
+typedef struct {
+  uint32_t triggers;       // soundPlay() calls while unmuted
+  uint32_t played;         // Cues played to the end
+  uint32_t preempted;      // Cues cut short by a newer one
+  uint32_t skipped;        // Queued cues replaced before they started
+  uint32_t dropped;        // Cues lost to a full queue
+  uint32_t lastTriggerUs;  // Caller's cost of the last soundPlay()
+  uint32_t maxTriggerUs;
+  uint32_t lastCueCpuUs;   // Render/decode time of the last cue played
+  uint32_t lastLatencyUs;  // Trigger to first samples handed to I2S
+  uint32_t maxLatencyUs;
+} AudioStats;
+
 uint8_t getVolume();
 void setVolume(uint8_t _volume);
 bool audioInit();
+
+void soundPlay(SoundCue cue);
+
+// Block until every queued cue has played (false on timeout)
+bool soundWaitIdle(uint32_t timeoutMs);
+
+void audioGetStats(AudioStats* stats);
+
+// Sonification: a short tone at each rep whose pitch rises with the
+// velocity zone of the rep's mean velocity. repUs is micros() at the rep,
+// for the latency figures. Does nothing while sonification is off.
+bool getSonification();
+void setSonification(bool enabled);
+void soundRepTone(uint16_t meanMmS, uint32_t repUs);
+
 void playPowerOnSound();
 void playPowerOffSound();
 void playStartWorkoutSound();
@@ -0,0 +1,91 @@
+#ifndef _SPLASH_H_
+#define _SPLASH_H_
+
+#include <stdint.h>
+#include "image.h"
+
+// Run-length encoded splash logo, built from gImage_image at compile time.
+// Each run is one word: the top 2 bits pick a palette entry, the low 14
+// bits hold the run length minus one. Runs follow the image row by row and
+// may cross rows. Palette colors are native-endian RGB565.
+
+#define SPLASH_W        240
+#define SPLASH_H        280
+#define SPLASH_COLORS   4
+#define SPLASH_RUN_MAX  (1 << 14)
+#define SPLASH_FILL_MIN 32   // Shorter runs are sent as pixels rather than fills
+
+namespace splash {
+
+constexpr uint32_t kPixels = SPLASH_W * SPLASH_H;
+static_assert(sizeof(gImage_image) / sizeof(gImage_image[0]) == kPixels, "splash size");
+
+constexpr uint16_t swap16(uint16_t v) { return (uint16_t)((v >> 8) | (v << 8)); }
+
+struct Palette {
+  uint16_t color[SPLASH_COLORS];   // As stored in the image (big-endian)
+  uint8_t count;
+};
+
+constexpr Palette buildPalette() {
+  Palette p{};
+  for (uint32_t i = 0; i < kPixels; i++) {
+    uint16_t c = gImage_image[i];
+    bool found = false;
+    for (uint8_t k = 0; k < p.count; k++) found = found || p.color[k] == c;
+    if (!found) {
+      if (p.count == SPLASH_COLORS) return Palette{{}, SPLASH_COLORS + 1};
+      p.color[p.count++] = c;
+    }
+  }
+  return p;
+}
+
+constexpr Palette kPalette = buildPalette();
+static_assert(kPalette.count <= SPLASH_COLORS, "splash image has too many colors for the RLE");
+
+constexpr uint8_t paletteIndex(uint16_t c) {
+  for (uint8_t k = 0; k < kPalette.count; k++) {
+    if (kPalette.color[k] == c) return k;
+  }
+  return 0;
+}
+
+constexpr uint32_t countRuns() {
+  uint32_t runs = 0;
+  for (uint32_t i = 0; i < kPixels;) {
+    uint32_t n = 1;
+    while (i + n < kPixels && n < SPLASH_RUN_MAX && gImage_image[i + n] == gImage_image[i]) n++;
+    i += n;
+    runs++;
+  }
+  return runs;
+}
+
+constexpr uint32_t kRuns = countRuns();
+
+struct Image {
+  uint16_t palette[SPLASH_COLORS];
+  uint16_t runs[kRuns];
+};
+
+constexpr Image encode() {
+  Image img{};
+  for (uint8_t k = 0; k < kPalette.count; k++) img.palette[k] = swap16(kPalette.color[k]);
+
+  uint32_t r = 0;
+  for (uint32_t i = 0; i < kPixels;) {
+    uint32_t n = 1;
+    while (i + n < kPixels && n < SPLASH_RUN_MAX && gImage_image[i + n] == gImage_image[i]) n++;
+    img.runs[r++] = (uint16_t)((paletteIndex(gImage_image[i]) << 14) | (n - 1));
+    i += n;
+  }
+  return img;
+}
+
+}  // namespace splash
+
+static constexpr splash::Image kSplash = splash::encode();
+#define SPLASH_RUNS splash::kRuns
+
+#endif
@@ -1,11 +1,51 @@
 #include "storage.h"
+#include "config.h"
 #include <LittleFS.h>
 
+#define LOG_META_PATH   LOG_SEGMENT_DIR "/meta"
+#define LOG_MERGE_PATH  LOG_SEGMENT_DIR "/merge.tmp"
+#define LOG_META_MAGIC  0x4C594654u  // "LYFT"
+#define FS_BLOCK_SIZE   4096
+
+typedef struct {
+  uint32_t firstSeq;  // Sequence number of the first row (also the file name)
+  uint32_t size;      // Bytes, header included
+} LogSegment;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t activeFirstSeq;  // Sequence number of the first row in LOGFILE
+  uint32_t syncedSeq;       // Rows below this have been synced
+} LogMeta;
+
 static bool g_fs_ready = false;
 
+// Session log state (segments sorted by firstSeq)
+static LogSegment g_segs[LOG_MAX_SEGMENTS];
+static uint16_t g_segCount = 0;
+static LogMeta g_meta = {LOG_META_MAGIC, 0, 0};
+static uint32_t g_activeRows = 0;
+static uint32_t g_activeSize = 0;
+
+// Maintenance state
+static unsigned long g_lastMaintMs = 0;
+static bool g_quotaWarned = false;
+static bool g_merging = false;
+static uint16_t g_mergeIdx = 0;      // Merges g_segs[idx + 1] into g_segs[idx]
+static bool g_mergeSecond = false;   // Copying the second segment
+static File g_mergeIn;
+static File g_mergeOut;
+static uint8_t g_chunk[STORAGE_MAINT_CHUNK];
+
+// Open log cursors; files must stay put while they read
+static uint8_t g_openCursors = 0;
+
+static void logLoad();
+
 bool storageInit(bool formatOnFail = false) {
   if (g_fs_ready) return true;
   g_fs_ready = LittleFS.begin(formatOnFail);
+  if (g_fs_ready) logLoad();
   return g_fs_ready;
 }
 
@@ -41,32 +81,49 @@ bool appendToFile(const char* path, const String& row) {
   return (n == row.length());
 }
 
-bool readFile(const char* path, String& out) {
+static bool cursorReadLine(StorageCursor* c, StorageLine* line);
+
+// Stream line-by-line (better for large files / BLE chunking)
+bool readFileByLine(const char* path, csv_line_cb_t stream, void* ctx) {
+  if (!g_fs_ready || stream == nullptr) return false;
+
+  StorageCursor c;
+  c.file = LittleFS.open(path, "r");
+  if (!c.file) return false;
+  c.head = c.tail = 0;
+  c.skipping = false;
+  c.truncated = 0;
+
+  StorageLine line;
+  while (cursorReadLine(&c, &line)) {
+    stream(line.data, line.len, ctx);
+  }
+
+  c.file.close();
+  return true;
+}
+
+// Fixed-size binary records (settings, cursors)
+bool readFileBytes(const char* path, void* buf, size_t len) {
   if (!g_fs_ready) return false;
 
   File f = LittleFS.open(path, "r");
   if (!f) return false;
 
-  out = f.readString(); // reads until EOF
+  size_t n = f.read((uint8_t*)buf, len);
   f.close();
-  return true;
+  return n == len;
 }
 
-// Stream line-by-line (better for large files / BLE chunking)
-bool readFileByLine(const char* path, csv_line_cb_t stream) {
-  if (!g_fs_ready || stream == nullptr) return false;
+bool writeFileBytes(const char* path, const void* buf, size_t len) {
+  if (!g_fs_ready) return false;
 
-  File f = LittleFS.open(path, "r");
+  File f = LittleFS.open(path, "w");
   if (!f) return false;
 
-  while (f.available()) {
-    String line = f.readStringUntil('\n');
-    if (line.endsWith("\r")) line.remove(line.length() - 1); // handle CRLF
-    stream(line);
-  }
-
+  size_t n = f.write((const uint8_t*)buf, len);
   f.close();
-  return true;
+  return n == len;
 }
 
 // Read in fixed-size chunks (ideal for BLE notifications)
@@ -90,3 +147,510 @@ bool readFileByChunks(const char* path, size_t chunkSize, csv_chunk_cb_t stream)
   f.close();
   return true;
 }
+
+// ============================================================================
+// Session log
+// ============================================================================
+
+static void segPath(char* buf, size_t len, uint32_t firstSeq) {
+  snprintf(buf, len, "%s/%08lu.csv", LOG_SEGMENT_DIR, (unsigned long)firstSeq);
+}
+
+// End (exclusive) of the rows held by segment i
+static uint32_t segEndSeq(uint16_t i) {
+  return (i + 1 < g_segCount) ? g_segs[i + 1].firstSeq : g_meta.activeFirstSeq;
+}
+
+static bool saveMeta() {
+  File f = LittleFS.open(LOG_META_PATH, "w");
+  if (!f) return false;
+  size_t n = f.write((const uint8_t*)&g_meta, sizeof(g_meta));
+  f.close();
+  return n == sizeof(g_meta);
+}
+
+// Count data rows (lines after the header) and bytes in a log file
+static uint32_t countRows(const char* path, uint32_t* size) {
+  File f = LittleFS.open(path, "r");
+  if (!f) {
+    if (size) *size = 0;
+    return 0;
+  }
+
+  uint32_t lines = 0;
+  int n;
+  while ((n = f.read(g_chunk, sizeof(g_chunk))) > 0) {
+    for (int i = 0; i < n; i++) {
+      if (g_chunk[i] == '\n') lines++;
+    }
+  }
+  if (size) *size = f.size();
+  f.close();
+
+  return lines > 0 ? lines - 1 : 0;
+}
+
+static void logLoad() {
+  g_segCount = 0;
+  g_activeRows = 0;
+  g_activeSize = 0;
+
+  if (!LittleFS.exists(LOG_SEGMENT_DIR)) LittleFS.mkdir(LOG_SEGMENT_DIR);
+
+  // An unfinished merge never replaced its source segments, just drop it
+  if (LittleFS.exists(LOG_MERGE_PATH)) LittleFS.remove(LOG_MERGE_PATH);
+
+  File mf = LittleFS.open(LOG_META_PATH, "r");
+  LogMeta meta;
+  if (mf && mf.read((uint8_t*)&meta, sizeof(meta)) == sizeof(meta) && meta.magic == LOG_META_MAGIC) {
+    g_meta = meta;
+  } else {
+    g_meta = {LOG_META_MAGIC, 0, 0};
+  }
+  if (mf) mf.close();
+
+  // Collect sealed segments, sorted by first sequence number
+  File dir = LittleFS.open(LOG_SEGMENT_DIR);
+  if (dir && dir.isDirectory()) {
+    File f = dir.openNextFile();
+    while (f && g_segCount < LOG_MAX_SEGMENTS) {
+      const char* name = strrchr(f.name(), '/');
+      name = name ? name + 1 : f.name();
+
+      char* end = nullptr;
+      unsigned long seq = strtoul(name, &end, 10);
+      if (end != name && strcmp(end, ".csv") == 0) {
+        uint16_t i = g_segCount++;
+        while (i > 0 && g_segs[i - 1].firstSeq > seq) {
+          g_segs[i] = g_segs[i - 1];
+          i--;
+        }
+        g_segs[i] = {(uint32_t)seq, (uint32_t)f.size()};
+      }
+      f.close();
+      f = dir.openNextFile();
+    }
+    dir.close();
+  }
+
+  // A roll that renamed the active file but didn't save meta
+  if (g_segCount > 0 && g_segs[g_segCount - 1].firstSeq >= g_meta.activeFirstSeq) {
+    char path[32];
+    LogSegment& last = g_segs[g_segCount - 1];
+    segPath(path, sizeof(path), last.firstSeq);
+    g_meta.activeFirstSeq = last.firstSeq + countRows(path, nullptr);
+    saveMeta();
+  }
+
+  g_activeRows = countRows(LOGFILE, &g_activeSize);
+
+  Serial.printf("Storage: %u segments, rows %lu..%lu, synced < %lu\n",
+                g_segCount,
+                (unsigned long)storageLogFirstSeq(),
+                (unsigned long)storageLogNextSeq(),
+                (unsigned long)g_meta.syncedSeq);
+}
+
+bool storageLogAppend(const char* header, const char* row) {
+  if (!g_fs_ready) return false;
+
+  if (!LittleFS.exists(LOGFILE)) {
+    File f = LittleFS.open(LOGFILE, "w");
+    if (!f) return false;
+    size_t n = f.print(header);
+    n += f.print("\n");
+    f.close();
+    if (n != strlen(header) + 1) return false;
+    g_activeRows = 0;
+    g_activeSize = n;
+  }
+
+  File f = LittleFS.open(LOGFILE, "a");
+  if (!f) return false;
+
+  size_t len = strlen(row);
+  size_t n = f.print(row);
+  f.close();
+
+  g_activeSize += n;
+  if (n != len) return false;
+
+  g_activeRows++;
+  return true;
+}
+
+bool storageLogForEachLine(csv_line_cb_t stream, void* ctx) {
+  if (stream == nullptr) return false;
+
+  StorageCursor c;
+  if (!storageCursorOpen(&c, 0)) return false;
+
+  StorageLine line;
+  while (storageCursorNext(&c, &line)) {
+    stream(line.data, line.len, ctx);
+  }
+
+  storageCursorClose(&c);
+  return true;
+}
+
+uint32_t storageLogFirstSeq() {
+  return g_segCount > 0 ? g_segs[0].firstSeq : g_meta.activeFirstSeq;
+}
+
+uint32_t storageLogNextSeq() {
+  return g_meta.activeFirstSeq + g_activeRows;
+}
+
+uint32_t storageLogSyncedSeq() {
+  return g_meta.syncedSeq;
+}
+
+// Seal the active file into a segment
+static bool logRoll() {
+  if (g_activeRows == 0 || g_segCount >= LOG_MAX_SEGMENTS) return false;
+
+  char path[32];
+  segPath(path, sizeof(path), g_meta.activeFirstSeq);
+  if (!LittleFS.rename(LOGFILE, path)) return false;
+
+  g_segs[g_segCount++] = {g_meta.activeFirstSeq, g_activeSize};
+  g_meta.activeFirstSeq += g_activeRows;
+  g_activeRows = 0;
+  g_activeSize = 0;
+  saveMeta();
+
+  Serial.printf("Storage: rolled log into %s\n", path);
+  return true;
+}
+
+void storageLogMarkSynced(uint32_t seq) {
+  if (!g_fs_ready) return;
+
+  uint32_t next = storageLogNextSeq();
+  if (seq > next) seq = next;
+  if (seq <= g_meta.syncedSeq) return;
+
+  g_meta.syncedSeq = seq;
+  g_quotaWarned = false;
+  saveMeta();
+}
+
+static void removeSegment(uint16_t i) {
+  char path[32];
+  segPath(path, sizeof(path), g_segs[i].firstSeq);
+  LittleFS.remove(path);
+
+  for (uint16_t j = i; j + 1 < g_segCount; j++) {
+    g_segs[j] = g_segs[j + 1];
+  }
+  g_segCount--;
+}
+
+static size_t logBytes() {
+  size_t total = g_activeSize;
+  for (uint16_t i = 0; i < g_segCount; i++) total += g_segs[i].size;
+  return total;
+}
+
+static void mergeAbort() {
+  if (g_mergeIn) g_mergeIn.close();
+  if (g_mergeOut) g_mergeOut.close();
+  LittleFS.remove(LOG_MERGE_PATH);
+  g_merging = false;
+}
+
+static bool mergeBegin(uint16_t idx) {
+  char path[32];
+  segPath(path, sizeof(path), g_segs[idx].firstSeq);
+
+  g_mergeIn = LittleFS.open(path, "r");
+  g_mergeOut = LittleFS.open(LOG_MERGE_PATH, "w");
+  if (!g_mergeIn || !g_mergeOut) {
+    mergeAbort();
+    return false;
+  }
+
+  g_mergeIdx = idx;
+  g_mergeSecond = false;
+  g_merging = true;
+  return true;
+}
+
+// Copy one chunk; on completion swap the merged file in
+static void mergeStep() {
+  int n = g_mergeIn.read(g_chunk, sizeof(g_chunk));
+  if (n > 0) {
+    if (g_mergeOut.write(g_chunk, n) != (size_t)n) mergeAbort();
+    return;
+  }
+  g_mergeIn.close();
+
+  char path[32];
+  if (!g_mergeSecond) {
+    segPath(path, sizeof(path), g_segs[g_mergeIdx + 1].firstSeq);
+    g_mergeIn = LittleFS.open(path, "r");
+    if (!g_mergeIn) {
+      mergeAbort();
+      return;
+    }
+    // Skip the repeated header
+    int c;
+    while ((c = g_mergeIn.read()) >= 0 && c != '\n') {}
+    g_mergeSecond = true;
+    return;
+  }
+
+  uint32_t size = g_mergeOut.size();
+  g_mergeOut.close();
+
+  // If power is lost between these two steps the second segment's rows are
+  // stored twice; both halves are already synced so nothing is lost
+  segPath(path, sizeof(path), g_segs[g_mergeIdx].firstSeq);
+  if (!LittleFS.rename(LOG_MERGE_PATH, path)) {
+    mergeAbort();
+    return;
+  }
+  g_segs[g_mergeIdx].size = size;
+  removeSegment(g_mergeIdx + 1);
+  g_merging = false;
+
+  Serial.printf("Storage: compacted into %s (%lu bytes)\n", path, (unsigned long)size);
+}
+
+void storageMaintain() {
+  if (!g_fs_ready) return;
+
+  unsigned long now = millis();
+  if (now - g_lastMaintMs < STORAGE_MAINT_INTERVAL_MS) return;
+  g_lastMaintMs = now;
+
+  // Segments can't move or disappear under a reader
+  if (g_openCursors > 0) return;
+
+  // 1) Finish compaction already under way
+  if (g_merging) {
+    mergeStep();
+    return;
+  }
+
+  // 2) Seal the active file once it's big enough, or once every row in it
+  //    is synced so retention can age them out without touching anything
+  //    new (small segments made this way get merged below)
+  if (g_activeSize >= LOG_SEGMENT_MAX_BYTES && logRoll()) return;
+  if (g_meta.syncedSeq == storageLogNextSeq() && logRoll()) return;
+
+  // 3) Retention: age out the oldest segment when over quota
+  size_t total = LittleFS.totalBytes();
+  size_t used = LittleFS.usedBytes();
+  size_t freeBytes = total > used ? total - used : 0;
+  bool lowSpace = freeBytes < LOG_MIN_FREE_BYTES;
+
+  if (g_segCount > 0 && (lowSpace || logBytes() > LOG_QUOTA_BYTES || g_segCount >= LOG_MAX_SEGMENTS)) {
+    if (segEndSeq(0) <= g_meta.syncedSeq) {
+      Serial.printf("Storage: aging out rows %lu..%lu\n",
+                    (unsigned long)g_segs[0].firstSeq, (unsigned long)segEndSeq(0));
+      removeSegment(0);
+      return;
+    }
+    if (lowSpace) {
+      // Flash is nearly full; keeping old unsynced rows would break logging
+      Serial.printf("Storage: low space, dropping unsynced rows %lu..%lu\n",
+                    (unsigned long)g_segs[0].firstSeq, (unsigned long)segEndSeq(0));
+      removeSegment(0);
+      return;
+    }
+    if (!g_quotaWarned) {
+      g_quotaWarned = true;
+      Serial.println("Storage: over quota, waiting for sync");
+    }
+  }
+
+  // 4) Compaction: merge adjacent small synced segments
+  if (lowSpace) return;
+  for (uint16_t i = 0; i + 1 < g_segCount; i++) {
+    if (segEndSeq(i + 1) > g_meta.syncedSeq) break;
+    if (g_segs[i].size + g_segs[i + 1].size <= LOG_SEGMENT_MAX_BYTES) {
+      mergeBegin(i);
+      return;
+    }
+  }
+}
+
+void storageGetStats(StorageStats* stats) {
+  memset(stats, 0, sizeof(*stats));
+  if (!g_fs_ready) return;
+
+  stats->totalBytes = LittleFS.totalBytes();
+  stats->usedBytes = LittleFS.usedBytes();
+  stats->logBytes = logBytes();
+  stats->segments = g_segCount;
+  stats->firstSeq = storageLogFirstSeq();
+  stats->nextSeq = storageLogNextSeq();
+  stats->syncedSeq = g_meta.syncedSeq;
+
+  // Each file occupies whole blocks; the tail of the last one is slack
+  size_t allocated = 0;
+  size_t slack = 0;
+  for (uint16_t i = 0; i <= g_segCount; i++) {
+    uint32_t size = (i < g_segCount) ? g_segs[i].size : g_activeSize;
+    if (size == 0) continue;
+    size_t blocks = (size + FS_BLOCK_SIZE - 1) / FS_BLOCK_SIZE;
+    allocated += blocks * FS_BLOCK_SIZE;
+    slack += blocks * FS_BLOCK_SIZE - size;
+  }
+  stats->fragmentationPct = allocated ? (uint8_t)(slack * 100 / allocated) : 0;
+}
+
+// ============================================================================
+// Log cursor
+// ============================================================================
+
+// Next line from the cursor's file, terminator replaced by NUL in place.
+// Returns false at end of file.
+static bool cursorReadLine(StorageCursor* c, StorageLine* line) {
+  const uint16_t cap = STORAGE_CURSOR_BUF - 1;  // Room for the NUL
+
+  while (true) {
+    char* start = c->buf + c->head;
+    char* nl = (char*)memchr(start, '\n', c->tail - c->head);
+
+    if (nl) {
+      c->head = (uint16_t)(nl + 1 - c->buf);
+      if (c->skipping) {
+        // End of a row we already yielded truncated
+        c->skipping = false;
+        continue;
+      }
+      size_t len = nl - start;
+      if (len > 0 && start[len - 1] == '\r') len--;  // handle CRLF
+      start[len] = '\0';
+      line->data = start;
+      line->len = len;
+      line->truncated = false;
+      return true;
+    }
+
+    // Keep the partial line, make room behind it
+    if (c->head > 0) {
+      memmove(c->buf, c->buf + c->head, c->tail - c->head);
+      c->tail -= c->head;
+      c->head = 0;
+    }
+
+    if (c->tail == cap) {
+      // No terminator in a full buffer: hand out what fits, drop the rest
+      c->buf[cap] = '\0';
+      c->head = c->tail = 0;
+      if (c->skipping) continue;
+      c->skipping = true;
+      c->truncated++;
+      line->data = c->buf;
+      line->len = cap;
+      line->truncated = true;
+      return true;
+    }
+
+    int n = c->file.read((uint8_t*)c->buf + c->tail, cap - c->tail);
+    if (n <= 0) {
+      bool partial = c->tail > 0 && !c->skipping;
+      c->buf[c->tail] = '\0';
+      line->data = c->buf;
+      line->len = c->tail;
+      line->truncated = false;
+      c->head = c->tail = 0;
+      c->skipping = false;
+      return partial;  // Last line without terminator
+    }
+    c->tail += n;
+  }
+}
+
+// Open the next log file after the one just read, skipping files that
+// only hold rows below fromSeq
+static bool cursorOpenNext(StorageCursor* c) {
+  char path[32];
+
+  for (uint16_t i = 0; i < g_segCount; i++) {
+    if (c->started && g_segs[i].firstSeq <= c->fileSeq) continue;
+    if (segEndSeq(i) <= c->fromSeq) continue;
+
+    segPath(path, sizeof(path), g_segs[i].firstSeq);
+    c->file = LittleFS.open(path, "r");
+    if (!c->file) continue;
+
+    c->fileSeq = g_segs[i].firstSeq;
+    c->lineIdx = 0;
+    c->started = true;
+    return true;
+  }
+
+  if (c->started && g_meta.activeFirstSeq <= c->fileSeq) return false;
+  if (g_activeRows == 0 || storageLogNextSeq() <= c->fromSeq) return false;
+
+  c->file = LittleFS.open(LOGFILE, "r");
+  if (!c->file) return false;
+
+  c->fileSeq = g_meta.activeFirstSeq;
+  c->lineIdx = 0;
+  c->started = true;
+  return true;
+}
+
+bool storageCursorOpen(StorageCursor* c, uint32_t fromSeq) {
+  if (!g_fs_ready) return false;
+
+  c->fromSeq = fromSeq;
+  c->fileSeq = 0;
+  c->lineIdx = 0;
+  c->truncated = 0;
+  c->head = c->tail = 0;
+  c->started = false;
+  c->headerDone = false;
+  c->skipping = false;
+  c->open = true;
+
+  g_openCursors++;
+  return true;
+}
+
+bool storageCursorNext(StorageCursor* c, StorageLine* line) {
+  if (!c->open) return false;
+
+  while (true) {
+    if (!c->file && !cursorOpenNext(c)) return false;
+
+    if (!cursorReadLine(c, line)) {
+      c->file.close();
+      continue;
+    }
+
+    uint32_t idx = c->lineIdx++;
+    if (idx == 0) {
+      // Every file repeats the header; only pass it on once
+      if (c->headerDone) continue;
+      c->headerDone = true;
+      line->seq = c->fileSeq;
+      line->header = true;
+      return true;
+    }
+
+    line->seq = c->fileSeq + idx - 1;
+    line->header = false;
+    if (line->seq < c->fromSeq) continue;
+    return true;
+  }
+}
+
+void storageCursorClose(StorageCursor* c) {
+  if (!c->open) return;
+
+  if (c->file) c->file.close();
+  c->open = false;
+  if (g_openCursors > 0) g_openCursors--;
+
+  if (c->truncated > 0) {
+    Serial.printf("Storage: %lu rows truncated to %d bytes\n",
+                  (unsigned long)c->truncated, STORAGE_CURSOR_BUF - 1);
+  }
+}
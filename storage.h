@@ -2,9 +2,13 @@
 #define STORAGE_H
 
 #include <Arduino.h>
+#include <FS.h>
+#include "config.h"
 
-// Callback signature: void on_line(const String& line)
-typedef void (*csv_line_cb_t)(const String& line);
+// Callback signature: void on_line(const char* line, size_t len, void* ctx)
+// line points into a reusable buffer, is NUL-terminated and only valid
+// for the duration of the call
+typedef void (*csv_line_cb_t)(const char* line, size_t len, void* ctx);
 typedef void (*csv_chunk_cb_t)(const uint8_t* data, size_t len);
 
 bool storageInit(bool formatOnFail);
@@ -12,8 +16,76 @@ bool fileExists(const char* path);
 bool removeFile(const char* path);
 bool createFile(const char* path, const String& csv);
 bool appendToFile(const char* path, const String& row);
-bool readFile(const char* path, String& out);
-bool readFileByLine(const char* path, csv_line_cb_t stream);
+bool readFileByLine(const char* path, csv_line_cb_t stream, void* ctx);
+bool readFileBytes(const char* path, void* buf, size_t len);
+bool writeFileBytes(const char* path, const void* buf, size_t len);
 bool readFileByChunks(const char* path, size_t chunkSize, csv_chunk_cb_t stream);
 
+// ---- Session log ----
+// The log is the active file LOGFILE plus sealed segments in LOG_SEGMENT_DIR.
+// Every row gets a sequence number; a segment is named after its first row.
+
+typedef struct {
+  size_t totalBytes;         // Filesystem capacity
+  size_t usedBytes;          // Filesystem usage (including metadata)
+  size_t logBytes;           // Bytes held by the session log
+  uint16_t segments;         // Sealed segments on flash
+  uint8_t fragmentationPct;  // Unused space in blocks held by the log (0-100)
+  uint32_t firstSeq;         // Oldest row still stored
+  uint32_t nextSeq;          // Sequence number of the next row
+  uint32_t syncedSeq;        // Rows below this have been synced
+} StorageStats;
+
+// Append a CSV row (with trailing newline), creating the active file with header
+bool storageLogAppend(const char* header, const char* row);
+
+// Stream every stored row in order, header first
+bool storageLogForEachLine(csv_line_cb_t stream, void* ctx);
+
+uint32_t storageLogFirstSeq();
+uint32_t storageLogNextSeq();
+uint32_t storageLogSyncedSeq();
+
+// Record that all rows below seq are safely off the device. Only the
+// marker moves here; files are sealed later by storageMaintain(), which
+// waits for open cursors.
+void storageLogMarkSynced(uint32_t seq);
+
+// Run one bounded step of rolling/retention/compaction (call when idle)
+void storageMaintain();
+
+void storageGetStats(StorageStats* stats);
+
+// ---- Log cursor ----
+// Walks the session log without allocating; each line is a view into the
+// cursor's own buffer that stays valid until the next storageCursorNext().
+// Retention and compaction pause while any cursor is open.
+
+typedef struct {
+  const char* data;  // NUL-terminated, line terminator stripped
+  size_t len;
+  uint32_t seq;      // Row sequence number (first row of the file for the header)
+  bool header;       // CSV header line (yielded once, before any row)
+  bool truncated;    // Row was longer than the buffer and got cut
+} StorageLine;
+
+typedef struct {
+  File file;
+  uint32_t fromSeq;    // Skip rows below this
+  uint32_t fileSeq;    // First row of the file being read
+  uint32_t lineIdx;    // Line index within that file (0 = header)
+  uint32_t truncated;  // Rows cut to fit the buffer
+  uint16_t head;       // Buffered bytes: buf[head..tail)
+  uint16_t tail;
+  bool open;
+  bool started;        // A log file has been opened
+  bool headerDone;
+  bool skipping;       // Dropping the rest of a truncated row
+  char buf[STORAGE_CURSOR_BUF];
+} StorageCursor;
+
+bool storageCursorOpen(StorageCursor* c, uint32_t fromSeq);
+bool storageCursorNext(StorageCursor* c, StorageLine* line);
+void storageCursorClose(StorageCursor* c);
+
 #endif // STORAGE_H
@@ -0,0 +1,163 @@
+#ifndef _SYNTH_H_
+#define _SYNTH_H_
+
+#include <stdint.h>
+#include "config.h"
+
+// Fixed-point wavetable synth, usable at compile time and at run time.
+// Voices are oscillators: a 32-bit phase accumulator indexes a sine table
+// (top bits) and interpolates between neighbours (next 16 bits). The
+// envelope is a linear ramp whose per-sample step is worked out when the
+// voice starts, so no sample needs a division or a float. Active voices are
+// summed and saturated, so a harmonic plays with its tone.
+
+#define SINE_BITS   8
+#define SINE_SIZE   (1 << SINE_BITS)
+#define ENV_ONE     (1L << 30)   // Full envelope level
+#define SYNTH_CHUNK 256          // Samples per render (and I2S write)
+
+namespace synth {
+
+// sin(x) for |x| <= pi/2 (Taylor series, good to ~1e-7 there)
+constexpr double sinQuarter(double x) {
+  double term = x, sum = x;
+  for (int k = 1; k < 10; k++) {
+    term *= -x * x / ((2 * k) * (2 * k + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+struct Table {
+  int16_t v[SINE_SIZE + 1];   // One extra entry so interpolation never wraps
+};
+
+constexpr Table buildSine() {
+  Table t{};
+  const double pi = 3.14159265358979323846;
+  for (int i = 0; i <= SINE_SIZE; i++) {
+    double x = 2 * pi * (i % SINE_SIZE) / SINE_SIZE;
+    double s = x <= pi / 2 ? sinQuarter(x)
+             : x <= 3 * pi / 2 ? sinQuarter(pi - x)
+             : sinQuarter(x - 2 * pi);
+    double q = s * 32767;
+    t.v[i] = (int16_t)(q < 0 ? q - 0.5 : q + 0.5);
+  }
+  return t;
+}
+
+constexpr Table kSine = buildSine();
+
+struct Voice {
+  bool active;
+  uint32_t phase, dphase;   // Full turn = 2^32
+  int32_t amp;              // Peak, in sample units
+  int32_t env, envStep;     // Q30 level and its per-sample change
+  uint32_t pos, total;      // Samples played / to play
+  uint32_t attackS, releaseAt;
+};
+
+struct Bank {
+  Voice v[SYNTH_VOICES];
+};
+
+constexpr uint32_t msToSamples(uint32_t ms) {
+  return (uint64_t)AUDIO_SAMPLE_RATE * ms / 1000;
+}
+
+// Start a tone on a free voice (dropped if all are busy)
+constexpr void start(Bank &b, uint16_t freq, uint32_t ms, int16_t amp, uint32_t attackMs, uint32_t releaseMs) {
+  const uint32_t total = msToSamples(ms);
+  if (total == 0) return;
+
+  for (int i = 0; i < SYNTH_VOICES; i++) {
+    Voice &v = b.v[i];
+    if (v.active) continue;
+
+    uint32_t attackS = msToSamples(attackMs);
+    uint32_t releaseS = msToSamples(releaseMs);
+    if (attackS > total) attackS = total;
+    if (releaseS > total) releaseS = total;
+
+    v.phase = 0;
+    v.dphase = (uint32_t)(((uint64_t)freq << 32) / AUDIO_SAMPLE_RATE);
+    v.amp = amp;
+    v.pos = 0;
+    v.total = total;
+    v.attackS = attackS;
+    v.releaseAt = total - releaseS;
+    v.env = attackS ? 0 : ENV_ONE;
+    v.envStep = attackS ? ENV_ONE / (int32_t)attackS : 0;
+    v.active = true;
+    return;
+  }
+}
+
+// Fade every sounding voice out over ms (for a sound that is cut short)
+constexpr void release(Bank &b, uint32_t ms) {
+  uint32_t fadeS = msToSamples(ms);
+  if (fadeS == 0) fadeS = 1;
+
+  for (int i = 0; i < SYNTH_VOICES; i++) {
+    Voice &v = b.v[i];
+    if (!v.active || v.total - v.pos <= fadeS) continue;
+    v.releaseAt = v.pos;
+    v.total = v.pos + fadeS;
+  }
+}
+
+constexpr bool active(const Bank &b) {
+  for (int i = 0; i < SYNTH_VOICES; i++) {
+    if (b.v[i].active) return true;
+  }
+  return false;
+}
+
+// Mix n (up to SYNTH_CHUNK) samples of every active voice into out.
+// Returns how many of them any voice reached; the rest are silence.
+constexpr uint32_t render(Bank &b, int16_t *out, uint32_t n) {
+  int32_t mix[SYNTH_CHUNK] = {};
+  uint32_t used = 0;
+
+  for (int k = 0; k < SYNTH_VOICES; k++) {
+    Voice &v = b.v[k];
+    if (!v.active) continue;
+
+    uint32_t i = 0;
+    for (; i < n; i++) {
+      if (v.pos == v.attackS && v.pos < v.releaseAt) v.envStep = 0;
+      if (v.pos == v.releaseAt) {
+        uint32_t left = v.total - v.pos;
+        v.envStep = left ? -(v.env / (int32_t)left) : 0;
+      }
+
+      uint32_t idx = v.phase >> (32 - SINE_BITS);
+      int32_t frac = (v.phase >> (16 - SINE_BITS)) & 0xFFFF;
+      int32_t a = kSine.v[idx], c = kSine.v[idx + 1];
+      int32_t s = a + (((c - a) * frac) >> 16);
+
+      s = (s * v.amp) >> 15;
+      mix[i] += (s * (v.env >> 15)) >> 15;
+
+      v.phase += v.dphase;
+      v.env += v.envStep;
+      if (v.env < 0) v.env = 0;
+      if (++v.pos == v.total) {
+        v.active = false;
+        i++;
+        break;
+      }
+    }
+    if (i > used) used = i;
+  }
+
+  for (uint32_t i = 0; i < n; i++) {
+    int32_t s = mix[i];
+    out[i] = (int16_t)(s > 32767 ? 32767 : (s < -32768 ? -32768 : s));
+  }
+  return used;
+}
+
+}  // namespace synth
+
+#endif
@@ -0,0 +1,112 @@
+#include "telemetry.h"
+#include "config.h"
+
+#define TRACE_PERIOD_MS (1000 / TELEMETRY_TRACE_HZ)
+
+// ============================================================================
+// Queues (head = next write, tail = next read; indices only grow)
+// ============================================================================
+
+static RepSummary repQueue[TELEMETRY_REP_QUEUE];
+static volatile uint32_t repHead = 0;
+static volatile uint32_t repTail = 0;
+
+static int16_t traceQueue[TELEMETRY_TRACE_QUEUE];
+static uint32_t traceTimeMs[TELEMETRY_TRACE_QUEUE];
+static volatile uint32_t traceHead = 0;
+static volatile uint32_t traceTail = 0;
+
+static volatile bool traceEnabled = false;
+static volatile uint32_t overruns = 0;
+
+// Decimation: samples are averaged over TRACE_PERIOD_MS bins
+static uint32_t binStartMs = 0;
+static float binSum = 0.0f;
+static uint16_t binCount = 0;
+
+// ============================================================================
+// Producer
+// ============================================================================
+
+void telemetryReset() {
+  repTail = repHead;
+  traceTail = traceHead;
+  binStartMs = 0;
+  binSum = 0.0f;
+  binCount = 0;
+}
+
+void telemetryPushRep(const RepSummary* rep) {
+  if (repHead - repTail >= TELEMETRY_REP_QUEUE) {
+    overruns++;
+    return;
+  }
+  repQueue[repHead % TELEMETRY_REP_QUEUE] = *rep;
+  repHead = repHead + 1;
+}
+
+void telemetryPushSample(float velocity, uint32_t nowMs) {
+  if (!traceEnabled) return;
+
+  if (binCount == 0) binStartMs = nowMs;
+  binSum += velocity;
+  binCount++;
+  if (nowMs - binStartMs < TRACE_PERIOD_MS) return;
+
+  float mmS = binSum / binCount * 1000.0f;
+  binSum = 0.0f;
+  binCount = 0;
+
+  if (traceHead - traceTail >= TELEMETRY_TRACE_QUEUE) {
+    overruns++;
+    return;
+  }
+  uint32_t i = traceHead % TELEMETRY_TRACE_QUEUE;
+  traceQueue[i] = (int16_t)constrain(mmS, -32767.0f, 32767.0f);
+  traceTimeMs[i] = nowMs;
+  traceHead = traceHead + 1;
+}
+
+// ============================================================================
+// Consumer
+// ============================================================================
+
+void telemetrySetTrace(bool enabled) {
+  traceEnabled = enabled;
+}
+
+bool telemetryTraceEnabled() {
+  return traceEnabled;
+}
+
+bool telemetryPeekRep(RepSummary* rep) {
+  if (repTail == repHead) return false;
+  *rep = repQueue[repTail % TELEMETRY_REP_QUEUE];
+  return true;
+}
+
+void telemetryDropRep() {
+  if (repTail != repHead) repTail = repTail + 1;
+}
+
+size_t telemetryPeekTrace(int16_t* out, size_t max, uint16_t* firstIdx, uint32_t* oldestMs) {
+  uint32_t tail = traceTail;
+  size_t n = traceHead - tail;
+  if (n > max) n = max;
+
+  for (size_t k = 0; k < n; k++) {
+    out[k] = traceQueue[(tail + k) % TELEMETRY_TRACE_QUEUE];
+  }
+  *firstIdx = (uint16_t)tail;
+  if (n > 0) *oldestMs = traceTimeMs[tail % TELEMETRY_TRACE_QUEUE];
+  return n;
+}
+
+void telemetryDropTrace(size_t count) {
+  size_t n = traceHead - traceTail;
+  traceTail = traceTail + (count < n ? count : n);
+}
+
+uint32_t telemetryOverruns() {
+  return overruns;
+}
@@ -0,0 +1,43 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+
+// Output queues between the sampling path and the radio.
+// The producer side is a couple of stores per sample, so the integrator's
+// timing doesn't depend on BLE; bleUpdate() drains the queues. One producer
+// and one consumer, no locks.
+
+typedef struct {
+  uint16_t rep;           // Rep number within the set
+  uint16_t durationMs;    // Time since the previous rep (or set start)
+  uint16_t peakMmS;       // Peak |velocity| during the rep (mm/s)
+  uint16_t meanMmS;       // Mean |velocity| during the rep (mm/s)
+  uint32_t setTimeMs;     // Rep end, relative to set start
+  uint32_t detectedUs;    // micros() at detection, for latency measurement
+} RepSummary;
+
+// ---- Producer (sampling path) ----
+
+void telemetryReset();
+void telemetryPushRep(const RepSummary* rep);
+void telemetryPushSample(float velocity, uint32_t nowMs);
+
+// ---- Consumer (BLE) ----
+
+// Velocity trace is only recorded while someone wants it
+void telemetrySetTrace(bool enabled);
+bool telemetryTraceEnabled();
+
+bool telemetryPeekRep(RepSummary* rep);
+void telemetryDropRep();
+
+// Copy up to max trace samples (mm/s) without removing them; firstIdx is
+// the running index of the first one so gaps are visible to the receiver
+size_t telemetryPeekTrace(int16_t* out, size_t max, uint16_t* firstIdx, uint32_t* oldestMs);
+void telemetryDropTrace(size_t count);
+
+// Samples and reps lost because the queues were full
+uint32_t telemetryOverruns();
+
+#endif // TELEMETRY_H
@@ -0,0 +1,199 @@
+// Host stand-in for a gym-floor hub: N simulated devices advertise their
+// ProtoAdv summary the way ble.cpp's advBuild() does, a scanner sees each
+// report several times or not at all (plus other vendors' data), and the
+// aggregator must end up with every device's latest state.
+
+#include "proto.h"
+#include <stdio.h>
+#include <string.h>
+
+#define DEVICES      40
+#define ROUNDS       600    // One per BLE_ADV_UPDATE_MS
+#define COMPANY_ID   0xFFFF
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static uint32_t rngState = 0x2468ACE1;
+static uint32_t rng() {
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static bool advEqual(const ProtoAdv* a, const ProtoAdv* b) {
+    return a->companyId == b->companyId && a->deviceId == b->deviceId && a->counter == b->counter &&
+           a->flags == b->flags && a->battery == b->battery && a->reps == b->reps &&
+           a->peakMmS == b->peakMmS && a->meanMmS == b->meanMmS;
+}
+
+// ---- Device side: what advBuild() does with the workout state ----
+
+typedef struct {
+    ProtoAdv state;
+    uint8_t mfr[PROTO_ADV_LEN];
+    uint32_t changes;
+} Device;
+
+// Re-encode; the counter only moves when something else changed
+static bool deviceBuild(Device* d) {
+    uint8_t m[PROTO_ADV_LEN];
+    protoAdvEncode(&d->state, m);
+    if (memcmp(m, d->mfr, sizeof(m)) == 0) return false;
+
+    d->state.counter++;
+    protoAdvEncode(&d->state, d->mfr);
+    d->changes++;
+    return true;
+}
+
+static void deviceStep(Device* d) {
+    ProtoAdv* s = &d->state;
+    switch (rng() % 8) {
+        case 0:   // Start or stop a set
+            s->flags ^= PROTO_ADV_SET_ACTIVE;
+            if (s->flags & PROTO_ADV_SET_ACTIVE) s->flags |= PROTO_ADV_RUNNING | PROTO_ADV_UNSYNCED;
+            else s->reps = 0;
+            break;
+        case 1:
+        case 2:   // A rep
+            if (s->flags & PROTO_ADV_SET_ACTIVE) {
+                s->reps++;
+                s->peakMmS = 300 + rng() % 900;
+                s->meanMmS = s->peakMmS / 2;
+            }
+            break;
+        case 3:   // Battery drains a little
+            if (rng() % 4 == 0 && s->battery > 0) s->battery--;
+            break;
+        default:  // Nothing new: the report repeats
+            break;
+    }
+}
+
+// ---- Hub side ----
+
+typedef struct {
+    bool used;
+    ProtoAdv last;
+} HubEntry;
+
+static HubEntry hub[DEVICES * 2];
+static uint32_t hubUpdates = 0, hubRepeats = 0, hubForeign = 0;
+
+static void hubReport(const uint8_t* data, size_t len) {
+    ProtoAdv adv;
+    if (!protoAdvDecode(data, len, &adv) || adv.companyId != COMPANY_ID) {
+        hubForeign++;
+        return;
+    }
+
+    HubEntry* free = NULL;
+    for (size_t i = 0; i < sizeof(hub) / sizeof(hub[0]); i++) {
+        if (hub[i].used && hub[i].last.deviceId == adv.deviceId) {
+            // Same counter, same report: nothing to decode further
+            if (hub[i].last.counter == adv.counter) {
+                hubRepeats++;
+                return;
+            }
+            hub[i].last = adv;
+            hubUpdates++;
+            return;
+        }
+        if (!hub[i].used && !free) free = &hub[i];
+    }
+    if (!free) return;
+    free->used = true;
+    free->last = adv;
+    hubUpdates++;
+}
+
+static const HubEntry* hubFind(uint32_t deviceId) {
+    for (size_t i = 0; i < sizeof(hub) / sizeof(hub[0]); i++) {
+        if (hub[i].used && hub[i].last.deviceId == deviceId) return &hub[i];
+    }
+    return NULL;
+}
+
+int main() {
+    static Device devices[DEVICES];
+    memset(devices, 0, sizeof(devices));
+    for (int i = 0; i < DEVICES; i++) {
+        // NIC part of a MAC, as bleInit() takes it
+        devices[i].state.companyId = COMPANY_ID;
+        devices[i].state.deviceId = (rng() & 0xFFFF00u) | (uint32_t)i;
+        devices[i].state.battery = 60 + rng() % 40;
+        deviceBuild(&devices[i]);
+    }
+
+    uint32_t sent = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        bool last = round == ROUNDS - 1;
+        for (int i = 0; i < DEVICES; i++) {
+            Device* d = &devices[i];
+            if (!last) deviceStep(d);
+            deviceBuild(d);
+
+            // Several advertising events per update; the scanner misses
+            // some, except in the last round so the final state is known
+            int copies = last ? 1 + rng() % 3 : rng() % 4;
+            for (int c = 0; c < copies; c++) {
+                hubReport(d->mfr, sizeof(d->mfr));
+                sent++;
+            }
+        }
+
+        // Other vendors and truncated reports on the same channel
+        uint8_t junk[PROTO_ADV_LEN + 4];
+        for (size_t k = 0; k < sizeof(junk); k++) junk[k] = (uint8_t)rng();
+        hubReport(junk, rng() % sizeof(junk));
+    }
+
+    // Every device is known, with its latest report
+    uint32_t running = 0, reps = 0, hubRunning = 0, hubReps = 0;
+    for (int i = 0; i < DEVICES; i++) {
+        const ProtoAdv* s = &devices[i].state;
+        const HubEntry* e = hubFind(s->deviceId);
+        CHECK(e != NULL);
+        if (!e) continue;
+        CHECK(advEqual(&e->last, s));
+
+        if (s->flags & PROTO_ADV_SET_ACTIVE) running++;
+        reps += s->reps;
+        if (e->last.flags & PROTO_ADV_SET_ACTIVE) hubRunning++;
+        hubReps += e->last.reps;
+    }
+    CHECK(running == hubRunning && reps == hubReps);
+
+    uint32_t tracked = 0;
+    for (size_t i = 0; i < sizeof(hub) / sizeof(hub[0]); i++) tracked += hub[i].used;
+    CHECK(tracked == DEVICES);
+
+    // A report from a later format with extra bytes still decodes
+    uint8_t longer[PROTO_ADV_LEN + 4];
+    memset(longer, 0xEE, sizeof(longer));
+    protoAdvEncode(&devices[0].state, longer);
+    ProtoAdv adv;
+    CHECK(protoAdvDecode(longer, sizeof(longer), &adv) && adv.deviceId == devices[0].state.deviceId);
+    CHECK(!protoAdvDecode(longer, PROTO_ADV_LEN - 1, &adv));
+    longer[2] = PROTO_ADV_FORMAT + 1;
+    CHECK(!protoAdvDecode(longer, sizeof(longer), &adv));
+
+    uint32_t changes = 0;
+    for (int i = 0; i < DEVICES; i++) changes += devices[i].changes;
+    printf("adv_test: %d devices, %lu reports (%lu changes), hub kept %lu updates, "
+           "dropped %lu repeats and %lu foreign\n",
+           DEVICES, (unsigned long)sent, (unsigned long)changes, (unsigned long)hubUpdates,
+           (unsigned long)hubRepeats, (unsigned long)hubForeign);
+
+    if (failures) {
+        printf("adv_test: %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("adv_test: all passed\n");
+    return 0;
+}
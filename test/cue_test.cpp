@@ -0,0 +1,96 @@
+// The ADPCM cue cache (cues.h, built at compile time) against the synth
+// it was rendered from: each cue decoded as sound.cpp streams it must be
+// as long as the live render (AUDIO_CUE_CACHE 0) and close to it.
+
+#include "cues.h"
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+#define MIN_SNR_DB 30.0
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+// What sound.cpp's playCue() sends with the cache off: the notes' voices
+// until they end, then the gap
+static std::vector<int16_t> renderLive(const Cue& cue) {
+    std::vector<int16_t> out;
+    synth::Bank bank{};
+    int16_t buf[SYNTH_CHUNK];
+
+    for (uint8_t i = 0; i < cue.count; i++) {
+        cues::startNote(bank, cue.notes[i]);
+        while (synth::active(bank)) {
+            uint32_t n = synth::render(bank, buf, SYNTH_CHUNK);
+            out.insert(out.end(), buf, buf + n);
+        }
+        for (uint32_t gap = synth::msToSamples(cue.notes[i].gapMs); gap > 0;) {
+            uint32_t n = gap > SYNTH_CHUNK ? SYNTH_CHUNK : gap;
+            synth::render(bank, buf, n);
+            out.insert(out.end(), buf, buf + n);
+            gap -= n;
+        }
+    }
+    return out;
+}
+
+// What its streamDecode() produces with the cache on
+static std::vector<int16_t> decodeCached(int cue) {
+    std::vector<int16_t> out;
+    const uint8_t* data = kCueCache.data + kCueCache.offset[cue];
+    cues::Adpcm st = {0, 0};
+    for (uint32_t pos = 0; pos < kCueCache.samples[cue]; pos++) {
+        uint8_t b = data[pos >> 1];
+        out.push_back(cues::decode(st, (pos & 1) ? b >> 4 : b & 0x0F));
+    }
+    return out;
+}
+
+static double snrDb(const std::vector<int16_t>& ref, const std::vector<int16_t>& got) {
+    double signal = 0, noise = 0;
+    for (size_t i = 0; i < ref.size(); i++) {
+        double e = (double)got[i] - ref[i];
+        signal += (double)ref[i] * ref[i];
+        noise += e * e;
+    }
+    return noise > 0 ? 10 * log10(signal / noise) : 999;
+}
+
+int main() {
+    uint32_t samples = 0;
+    double worst = 999;
+
+    for (int k = 0; k < SOUND_CUE_COUNT; k++) {
+        std::vector<int16_t> live = renderLive(cues::kCues[k]);
+        std::vector<int16_t> cached = decodeCached(k);
+
+        CHECK(live.size() == kCueCache.samples[k]);
+        CHECK(cached.size() == live.size());
+        if (cached.size() != live.size()) continue;
+
+        // Cues sit back to back, two samples a byte
+        uint32_t end = k + 1 < SOUND_CUE_COUNT ? kCueCache.offset[k + 1] : cues::kBytes;
+        CHECK(end - kCueCache.offset[k] == (kCueCache.samples[k] + 1) / 2);
+
+        double snr = snrDb(live, cached);
+        printf("cue %d: %5lu samples, %5lu bytes, SNR %.1f dB\n", k, (unsigned long)live.size(),
+               (unsigned long)(live.size() + 1) / 2, snr);
+        CHECK(snr >= MIN_SNR_DB);
+        if (snr < worst) worst = snr;
+        samples += live.size();
+    }
+
+    printf("cue_test: %lu samples in %lu bytes (%lu as 16-bit PCM), worst SNR %.1f dB\n",
+           (unsigned long)samples, (unsigned long)cues::kBytes, (unsigned long)samples * 2, worst);
+
+    if (failures) {
+        printf("cue_test: %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("cue_test: all passed\n");
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Panel traffic per UI action: the bus's pixelsSent()/bytesSent() (through
+// displayGetStats()) around a settings tap, a brightness slider drag step
+// and a rep update on the main screen, each run until the screen settles.
+//
+// Bytes include window commands, which the host ST7789 stand-in sends for
+// every primitive (see stubs/Arduino_GFX_Library.h), so they run a little
+// above the device's. Fails if an action repaints the whole screen.
+
+#include "display.h"
+#include "ui.h"
+#include "config.h"
+#include <string.h>
+#include "display_fakes.h"
+#include "host.h"
+
+#define RUNS        20
+#define FULL_PIXELS ((uint32_t)LCD_WIDTH * LCD_HEIGHT)
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+typedef struct {
+    uint32_t pixels;
+    uint32_t bytes;
+    uint32_t frames;
+} Cost;
+
+static Cost snapshot() {
+    DisplayStats st;
+    displayGetStats(&st);
+    return {st.busPixels, st.busBytes, st.frames};
+}
+
+// Widget on the active screen whose text starts with prefix
+static UiWidget* find(UiWidget* w, UiType type, const char* prefix) {
+    for (; w; w = w->next) {
+        if (w->type == type && w->text && !strncmp(w->text, prefix, strlen(prefix))) return w;
+        UiWidget* hit = find(w->child, type, prefix);
+        if (hit) return hit;
+    }
+    return nullptr;
+}
+
+static void report(const char* action, const Cost& total) {
+    printf("%-18s %8lu px %9lu bytes %5.1f frames  (%.1f%% of a full screen)\n", action,
+           (unsigned long)(total.pixels / RUNS), (unsigned long)(total.bytes / RUNS),
+           (double)total.frames / RUNS, 100.0 * total.pixels / RUNS / FULL_PIXELS);
+    CHECK(total.pixels / RUNS > 0);
+    CHECK(total.pixels / RUNS < FULL_PIXELS);
+}
+
+// Runs action RUNS times, settling after each, and reports the average
+template <typename F>
+static void measure(const char* name, F action) {
+    Cost total = {0, 0, 0};
+    for (int i = 0; i < RUNS; i++) {
+        Cost before = snapshot();
+        action(i);
+        displaySettle();
+        Cost after = snapshot();
+        total.pixels += after.pixels - before.pixels;
+        total.bytes += after.bytes - before.bytes;
+        total.frames += after.frames - before.frames;
+    }
+    report(name, total);
+}
+
+int main() {
+    hostSerialQuiet = true;
+    hostFsReset(4 * 1024 * 1024);
+    DateTime now = {2026, 3, 14, 9, 26};
+    fakeRtcSet(&now);
+    displayInit();
+
+    // ---- Settings: tap the BLE toggle ----
+    displayShowSettings();
+    displaySettle();
+    UiWidget* ble = find(uiActive(), UI_BUTTON, "BLE");
+    UiWidget* slider = find(uiActive(), UI_SLIDER, "BRIGHTNESS");
+    CHECK(ble && slider);
+    if (!ble || !slider) return 1;
+
+    Cost screen = snapshot();
+    displayShowSettings();
+    displaySettle();
+    Cost full = snapshot();
+    printf("%-18s %8lu px %9lu bytes\n", "settings redraw", (unsigned long)(full.pixels - screen.pixels),
+           (unsigned long)(full.bytes - screen.bytes));
+
+    measure("tap (BLE toggle)", [&](int) {
+        displaySettingsHandleTouch(ble->x + ble->w / 2, ble->y + ble->h / 2);
+    });
+
+    // ---- Settings: drag the brightness bar a step at a time ----
+    int16_t x0 = slider->x + slider->w / 2, y0 = slider->y + slider->h / 2;
+    measure("slider drag step", [&](int i) {
+        int16_t dx = (i % 2 ? -1 : 1) * slider->w / 10;
+        displayHandleDrag(x0, y0, x0 + dx, dx, true);
+    });
+
+    // ---- Main: a rep comes in ----
+    displayRedrawUI(80);
+    displaySettle();
+    fakeWorkoutSetActive(true);
+    uint32_t ms = 0;
+    measure("rep update", [&](int i) {
+        for (int t = 0; t < 2000; t += 20, ms += 20) {
+            float phase = t / 2000.0f;
+            displayChartAddSample(phase < 0.5f ? 1.2f * phase * 2 : 0, ms);
+        }
+        fakeWorkoutAddRep(600 - i * 5, 1200);
+        displayUpdateReps(i + 1);
+        displayUpdateTime(ms / 1000);
+        displayUpdatePeakVelocity(1.2f + i * 0.01f);
+        displayUpdateChart();
+    });
+
+    if (failures) {
+        printf("display_bench: %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("display_bench: all passed\n");
+    return 0;
+}
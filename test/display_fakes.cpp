@@ -0,0 +1,79 @@
+#include "display_fakes.h"
+#include "workout.h"
+#include "sound.h"
+#include "config.h"
+#include "host.h"
+
+#define FAKE_REPS 64
+
+static RepSummary reps[FAKE_REPS];
+static int repCount = 0;
+static bool setActive = false;
+static int sensitivity = 50;
+
+static uint8_t volume = AUDIO_VOLUME;
+static bool sonification = false;
+
+static bool rtcSet = false;
+static DateTime rtcNow;
+
+void fakeWorkoutReset() {
+    repCount = 0;
+    setActive = false;
+}
+
+void fakeWorkoutAddRep(uint16_t meanMmS, uint16_t peakMmS) {
+    if (repCount == FAKE_REPS) return;
+    RepSummary* r = &reps[repCount++];
+    memset(r, 0, sizeof(*r));
+    r->rep = repCount;
+    r->meanMmS = meanMmS;
+    r->peakMmS = peakMmS;
+    r->durationMs = 2000;
+    r->setTimeMs = repCount * 2000;
+}
+
+void fakeWorkoutSetActive(bool active) { setActive = active; }
+
+void fakeRtcSet(const DateTime* dt) {
+    rtcNow = *dt;
+    rtcSet = true;
+}
+
+int displaySettle() {
+    DisplayStats st;
+    displayGetStats(&st);
+    int painted = 0;
+    for (int i = 0; i < 1000; i++) {
+        uint32_t frames = st.frames;
+        hostAdvanceMs(DISPLAY_FRAME_MS);
+        displayRender();
+        displayGetStats(&st);
+        if (st.frames == frames) break;
+        painted++;
+    }
+    return painted;
+}
+
+// ---- workout.h ----
+
+bool workoutIsSetActive() { return setActive; }
+int getImuSensitivity() { return sensitivity; }
+void workoutSetSensitivity(int value) { sensitivity = value; }
+int workoutGetReps() { return repCount; }
+
+const RepSummary* workoutGetRep(int rep) {
+    return rep >= 1 && rep <= repCount ? &reps[rep - 1] : nullptr;
+}
+
+// ---- sound.h ----
+
+uint8_t getVolume() { return volume; }
+void setVolume(uint8_t v) { volume = v; }
+bool getSonification() { return sonification; }
+void setSonification(bool enabled) { sonification = enabled; }
+
+// ---- rtc.h ----
+
+bool rtcIsSet() { return rtcSet; }
+void rtcGetDateTime(DateTime* dt) { *dt = rtcNow; }
@@ -0,0 +1,20 @@
+// display.cpp on the host: stand-ins for the modules it reads (workout,
+// sound, rtc) with state the display tests set, and a frame loop.
+#ifndef DISPLAY_FAKES_H
+#define DISPLAY_FAKES_H
+
+#include "display.h"
+#include "rtc.h"
+
+// Workout seen by the rep chart and the readouts
+void fakeWorkoutReset();
+void fakeWorkoutAddRep(uint16_t meanMmS, uint16_t peakMmS);
+void fakeWorkoutSetActive(bool active);
+
+void fakeRtcSet(const DateTime* dt);
+
+// Run displayRender() a frame period apart until a frame paints nothing;
+// returns the frames that painted
+int displaySettle();
+
+#endif // DISPLAY_FAKES_H
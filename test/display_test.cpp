@@ -0,0 +1,153 @@
+// display.cpp, ui.cpp and lcdram.cpp on the host, drawing through the
+// Arduino_GFX stand-in into LcdRamBus: the main, settings, picker and error
+// screens are saved as PNGs and compared byte for byte with test/golden.
+//
+// After an intended change to a screen (or to the stand-in's drawing),
+// regenerate the goldens with LYFT_UPDATE_GOLDENS=1 and look at them
+// before committing. A mismatch leaves <screen>.actual.png in the working
+// directory.
+
+#include "display.h"
+#include "config.h"
+#include <LittleFS.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "display_fakes.h"
+#include "host.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+static std::vector<uint8_t> readFs(const char* path) {
+    std::vector<uint8_t> out;
+    File f = LittleFS.open(path, "r");
+    if (!f) return out;
+    out.resize(f.size());
+    f.read(out.data(), out.size());
+    return out;
+}
+
+static bool readHost(const char* path, std::vector<uint8_t>* out) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return false;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out->insert(out->end(), buf, buf + n);
+    fclose(f);
+    return true;
+}
+
+static bool writeHost(const char* path, const std::vector<uint8_t>& data) {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    fclose(f);
+    return ok;
+}
+
+// The visible screen against GOLDEN_DIR/<name>.png
+static void checkGolden(const char* name) {
+    std::vector<uint8_t> shot;
+    CHECK(displaySavePng("/shot.png"));
+    shot = readFs("/shot.png");
+    CHECK(shot.size() > 8);
+
+    char golden[256];
+    snprintf(golden, sizeof(golden), "%s/%s.png", GOLDEN_DIR, name);
+    if (getenv("LYFT_UPDATE_GOLDENS")) {
+        CHECK(writeHost(golden, shot));
+        printf("%s: wrote %s (%lu bytes)\n", name, golden, (unsigned long)shot.size());
+        return;
+    }
+
+    std::vector<uint8_t> want;
+    if (!readHost(golden, &want)) {
+        printf("%s: no golden at %s\n", name, golden);
+        failures++;
+        return;
+    }
+    if (shot != want) {
+        char actual[64];
+        snprintf(actual, sizeof(actual), "%s.actual.png", name);
+        writeHost(actual, shot);
+        printf("%s: differs from %s, see %s\n", name, golden, actual);
+        failures++;
+        return;
+    }
+    printf("%s: matches golden (%lu bytes)\n", name, (unsigned long)shot.size());
+}
+
+// The snapshot display.cpp saves by itself the first time a screen
+// settles; the same as the last shot unless the screen changed since
+static void checkSnapshot(const char* name, bool sameAsShot) {
+    char path[64];
+    snprintf(path, sizeof(path), "%s/%s.png", DISPLAY_SNAPSHOT_DIR, name);
+    CHECK(!readFs(path).empty());
+    if (sameAsShot) CHECK(readFs(path) == readFs("/shot.png"));
+}
+
+// A set of eight reps, with the velocity trace the IMU would feed
+static void playSet() {
+    static const uint16_t means[] = {620, 655, 640, 600, 580, 545, 510, 470};
+    uint32_t ms = 0;
+    fakeWorkoutSetActive(true);
+    for (int i = 0; i < 8; i++) {
+        for (int t = 0; t < 2000; t += 20, ms += 20) {
+            float phase = t / 2000.0f;
+            float v = phase < 0.5f ? means[i] * 2.0f * (phase * 2) / 1000 : 0;
+            displayChartAddSample(v, ms);
+        }
+        fakeWorkoutAddRep(means[i], means[i] * 2);
+        displayUpdateReps(i + 1);
+        displayUpdateTime(ms / 1000);
+        displayUpdatePeakVelocity(means[0] * 2 / 1000.0f);
+        displayUpdateChart();
+        displaySettle();
+    }
+}
+
+int main() {
+    hostSerialQuiet = true;
+    hostFsReset(4 * 1024 * 1024);
+    DateTime now = {2026, 3, 14, 9, 26};
+    fakeRtcSet(&now);
+
+    displayInit();
+
+    displayRedrawUI(80);
+    displaySettle();
+    playSet();
+    displaySettle();
+    checkGolden("main");
+    checkSnapshot("main", false);   // Taken before the set
+
+    displayShowSettings();
+    displaySettle();
+    checkGolden("settings");
+    checkSnapshot("settings", true);
+
+    displayShowDateTimePicker();
+    displaySettle();
+    checkGolden("picker");
+    checkSnapshot("picker", true);
+
+    displayError("Touch Error");
+    checkGolden("error");
+    checkSnapshot("error", true);
+
+    // Settled means settled: another frame paints nothing
+    displayRedrawUI(80);
+    displaySettle();
+    CHECK(displaySettle() == 0);
+
+    if (failures) {
+        printf("display_test: %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("display_test: all passed\n");
+    return 0;
+}
@@ -0,0 +1,224 @@
+// es8311.cpp's register shadow against a fake codec on the host Wire: init
+// and sound.cpp's volume/mic batch must leave the chip in the same state
+// register-by-register writes would, in the bursts the commit promises,
+// and es8311_restore() must cost one read when the codec kept its state
+// and put back exactly what it lost otherwise.
+
+#include "es8311.h"
+#include "es8311_reg.h"
+#include "config.h"
+#include <vector>
+#include "host.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+#define REGS 0x46   // The shadowed range, 0x00 - 0x45
+
+typedef struct {
+    uint8_t reg;
+    uint8_t len;
+} Burst;
+
+// Register file with auto-increment. The defaults are made up, with bits
+// the driver's read-modify-writes must keep, and REG00 = 0x1F loads them.
+class FakeEs8311 : public HostI2cDevice {
+public:
+    uint8_t regs[256] = {};
+    uint8_t ptr = 0;
+    bool nack = false;
+    std::vector<Burst> bursts;   // Register writes, in order
+
+    static uint8_t defaultOf(int reg) {
+        switch (reg) {
+            case ES8311_CLK_MANAGER_REG01: return 0x30;
+            case ES8311_CLK_MANAGER_REG02: return 0x05;
+            case ES8311_CLK_MANAGER_REG06: return 0x23;
+            case ES8311_CLK_MANAGER_REG07: return 0x40;
+            case ES8311_SYSTEM_REG0D: return 0xFC;
+            case ES8311_ADC_REG15: return 0x0A;
+            default: return (uint8_t)(reg * 7 + 1);
+        }
+    }
+
+    void powerCycle() {
+        for (int r = 0; r < REGS; r++) regs[r] = defaultOf(r);
+    }
+
+    bool write(const uint8_t* data, size_t len) override {
+        if (nack) return false;
+        ptr = data[0];
+        if (len > 1) bursts.push_back({data[0], (uint8_t)(len - 1)});
+        for (size_t i = 1; i < len; i++) {
+            if (ptr == ES8311_RESET_REG00 && data[i] == 0x1F) {
+                powerCycle();
+                regs[ES8311_RESET_REG00] = 0x1F;
+                ptr++;
+                continue;
+            }
+            regs[ptr++] = data[i];
+        }
+        return true;
+    }
+
+    size_t read(uint8_t* out, size_t len) override {
+        for (size_t i = 0; i < len; i++) out[i] = regs[ptr++];
+        return len;
+    }
+};
+
+static FakeEs8311 codec;
+
+// What init and the volume/mic setup leave behind, one register at a time
+// (AUDIO_MCLK_FREQ_HZ at AUDIO_SAMPLE_RATE: pre_div 1, x1, osr 0x10, bclk/4)
+static void expectedState(uint8_t* out) {
+    for (int r = 0; r < REGS; r++) out[r] = FakeEs8311::defaultOf(r);
+    out[ES8311_RESET_REG00] = 0x80;
+    out[ES8311_CLK_MANAGER_REG01] = 0x3F;
+    out[ES8311_CLK_MANAGER_REG02] = FakeEs8311::defaultOf(ES8311_CLK_MANAGER_REG02) & 0x07;
+    out[ES8311_CLK_MANAGER_REG03] = 0x10;
+    out[ES8311_CLK_MANAGER_REG04] = 0x10;
+    out[ES8311_CLK_MANAGER_REG05] = 0x00;
+    out[ES8311_CLK_MANAGER_REG06] = (FakeEs8311::defaultOf(ES8311_CLK_MANAGER_REG06) & 0xC0) | 0x03;
+    out[ES8311_CLK_MANAGER_REG07] = FakeEs8311::defaultOf(ES8311_CLK_MANAGER_REG07) & 0xC0;
+    out[ES8311_CLK_MANAGER_REG08] = 0xFF;
+    out[ES8311_SDPIN_REG09] = 0x0C;
+    out[ES8311_SDPOUT_REG0A] = 0x0C;
+    out[ES8311_SYSTEM_REG0D] = 0x01;
+    out[ES8311_SYSTEM_REG0E] = 0x02;
+    out[ES8311_SYSTEM_REG12] = 0x00;
+    out[ES8311_SYSTEM_REG13] = 0x10;
+    out[ES8311_SYSTEM_REG14] = 0x1A;
+    out[ES8311_ADC_REG17] = 0xC8;
+    out[ES8311_ADC_REG1C] = 0x6A;
+    out[ES8311_DAC_REG32] = AUDIO_VOLUME * 256 / 100 - 1;
+    out[ES8311_DAC_REG37] = 0x08;
+}
+
+static bool hasBurst(uint8_t reg, uint8_t len) {
+    for (const Burst& b : codec.bursts) {
+        if (b.reg == reg && b.len == len) return true;
+    }
+    return false;
+}
+
+static int firstDiff(const uint8_t* want) {
+    for (int r = 0; r < REGS; r++) {
+        if (codec.regs[r] != want[r]) return r;
+    }
+    return -1;
+}
+
+int main() {
+    hostI2cAttach(ES8311_ADDRESS_0, &codec);
+    codec.powerCycle();
+
+    // ---- Init, as audioInit() runs it ----
+    es8311_handle_t es = es8311_create(I2C_NUM_0, ES8311_ADDRESS_0);
+    const es8311_clock_config_t clk = {false, false, true, AUDIO_MCLK_FREQ_HZ, AUDIO_SAMPLE_RATE};
+    CHECK(es8311_init(es, &clk, ES8311_RESOLUTION_16, ES8311_RESOLUTION_16) == ESP_OK);
+    es8311_batch_begin(es);
+    es8311_voice_volume_set(es, AUDIO_VOLUME, NULL);
+    es8311_microphone_config(es, false);
+    CHECK(es8311_batch_commit(es) == ESP_OK);
+
+    uint8_t want[REGS];
+    expectedState(want);
+    int diff = firstDiff(want);
+    CHECK(diff < 0);
+    if (diff >= 0) printf("REG%02X is 0x%02X, want 0x%02X\n", diff, codec.regs[diff], want[diff]);
+
+    // Reset sequence one by one, then a burst per run of registers: gaps
+    // of registers never read cannot be bridged
+    uint32_t reads, writes;
+    es8311_i2c_counts(es, &reads, &writes);
+    printf("init: %lu reads, %lu writes in %u bursts\n", (unsigned long)reads, (unsigned long)writes,
+           (unsigned)codec.bursts.size());
+    CHECK(reads == 3);   // REG02, REG06, REG07, once each
+    CHECK(writes == codec.bursts.size());
+    CHECK(writes == 11);
+    CHECK(hasBurst(ES8311_RESET_REG00, 11));   // REG00 - REG0A
+    CHECK(hasBurst(ES8311_SYSTEM_REG0D, 2));
+    CHECK(hasBurst(ES8311_SYSTEM_REG12, 2));
+    CHECK(hasBurst(ES8311_SYSTEM_REG14, 1));
+    CHECK(hasBurst(ES8311_ADC_REG17, 1));
+    CHECK(hasBurst(ES8311_ADC_REG1C, 1));
+    CHECK(hasBurst(ES8311_DAC_REG32, 1));
+    CHECK(hasBurst(ES8311_DAC_REG37, 1));
+
+    // ---- Reads come from the shadow ----
+    uint32_t busReads = hostI2cReads;
+    int volume = 0;
+    CHECK(es8311_voice_volume_get(es, &volume) == ESP_OK);
+    CHECK(volume == AUDIO_VOLUME);
+    CHECK(hostI2cReads == busReads);
+
+    // ---- A gap of up to ES8311_BURST_MAX_GAP known registers is bridged ----
+    es8311_microphone_gain_set(es, ES8311_MIC_GAIN_6DB);   // REG16, sent now
+    es8311_microphone_fade(es, ES8311_FADE_4LRCK);         // Reads and sends REG15
+    want[ES8311_ADC_REG16] = ES8311_MIC_GAIN_6DB;
+    want[ES8311_ADC_REG15] = (FakeEs8311::defaultOf(ES8311_ADC_REG15) & 0x0F) | (ES8311_FADE_4LRCK << 4);
+    codec.bursts.clear();
+    es8311_batch_begin(es);
+    es8311_microphone_config(es, true);                    // REG17 and REG14
+    CHECK(codec.bursts.empty());
+    CHECK(es8311_batch_commit(es) == ESP_OK);
+    want[ES8311_SYSTEM_REG14] = 0x1A | 0x40;
+    CHECK(codec.bursts.size() == 1 && hasBurst(ES8311_SYSTEM_REG14, 4));
+    CHECK(firstDiff(want) < 0);
+
+    // An empty batch sends nothing
+    codec.bursts.clear();
+    es8311_batch_begin(es);
+    CHECK(es8311_batch_commit(es) == ESP_OK);
+    CHECK(codec.bursts.empty());
+
+    // ---- Restore after a sleep that kept the state: one read ----
+    uint32_t reads0, writes0;
+    es8311_i2c_counts(es, &reads0, &writes0);
+    CHECK(es8311_restore(es) == ESP_OK);
+    es8311_i2c_counts(es, &reads, &writes);
+    CHECK(reads - reads0 == 1 && writes == writes0);
+    CHECK(codec.bursts.empty());
+
+    // ---- Restore after a sleep that lost it ----
+    codec.powerCycle();
+    es8311_i2c_counts(es, &reads0, &writes0);
+    CHECK(es8311_restore(es) == ESP_OK);
+    es8311_i2c_counts(es, &reads, &writes);
+    printf("restore after power loss: %lu read, %lu writes\n", (unsigned long)(reads - reads0),
+           (unsigned long)(writes - writes0));
+    CHECK(reads - reads0 == 1);
+    CHECK(writes - writes0 == codec.bursts.size());
+    // REG00 - REG0A, REG0D - REG0E, REG12 - REG17 (gap bridged), REG1C, REG32, REG37
+    CHECK(writes - writes0 == 6);
+    CHECK(hasBurst(ES8311_SYSTEM_REG12, 6));
+    diff = firstDiff(want);
+    CHECK(diff < 0);
+    if (diff >= 0) printf("REG%02X is 0x%02X, want 0x%02X\n", diff, codec.regs[diff], want[diff]);
+
+    // The shadow still answers for what it restored
+    busReads = hostI2cReads;
+    CHECK(es8311_voice_volume_get(es, &volume) == ESP_OK && volume == AUDIO_VOLUME);
+    CHECK(hostI2cReads == busReads);
+
+    // ---- Bus errors come back to the caller ----
+    codec.nack = true;
+    CHECK(es8311_restore(es) != ESP_OK);
+    es8311_batch_begin(es);
+    es8311_voice_volume_set(es, 50, NULL);
+    CHECK(es8311_batch_commit(es) != ESP_OK);
+    codec.nack = false;
+
+    es8311_delete(es);
+
+    if (failures) {
+        printf("es8311_test: %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("es8311_test: all passed\n");
+    return 0;
+}
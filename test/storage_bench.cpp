@@ -0,0 +1,129 @@
+// Reading a 1 MB session log back, as a sync does: the String-per-line loop
+// storageLogForEachLine() used to run against today's cursor. Counts heap
+// allocations (host_alloc.cpp) and host CPU time over in-memory files, so
+// the figures cover the parsing side only, not flash reads.
+//
+// Fails if the cursor path allocates or yields different rows.
+
+#include "storage.h"
+#include <LittleFS.h>
+#include <chrono>
+#include <vector>
+#include <string>
+#include "host.h"
+
+#define LOG_TARGET_BYTES (1024 * 1024)
+#define RUNS             5
+
+static const char* kHeader = "date,time,exercise,set,reps,peak,mean";
+
+typedef struct {
+    uint64_t rows;
+    uint64_t bytes;
+} Sink;
+
+// The old loop, over the same files in the same order
+static void legacyForEachLine(Sink* sink) {
+    std::vector<std::string> paths;
+    File dir = LittleFS.open(LOG_SEGMENT_DIR);
+    File f = dir.openNextFile();
+    while (f) {
+        paths.push_back(std::string(LOG_SEGMENT_DIR "/") + f.name());
+        f = dir.openNextFile();
+    }
+    std::sort(paths.begin(), paths.end());
+    paths.push_back(LOGFILE);
+
+    bool headerSent = false;
+    for (const std::string& path : paths) {
+        File in = LittleFS.open(path.c_str(), "r");
+        if (!in) continue;
+
+        bool firstLine = true;
+        while (in.available()) {
+            String line = in.readStringUntil('\n');
+            if (firstLine) {
+                firstLine = false;
+                if (headerSent) continue;
+                headerSent = true;
+            }
+            // What ble.cpp sent per row: bleSend(line + "\n")
+            String out = line + "\n";
+            sink->rows++;
+            sink->bytes += out.length();
+        }
+    }
+}
+
+static void cursorLine(const char* line, size_t len, void* ctx) {
+    Sink* sink = (Sink*)ctx;
+    sink->rows++;
+    sink->bytes += len + 1;
+}
+
+static double seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    hostSerialQuiet = true;
+    hostFsReset(4 * 1024 * 1024);
+    if (!storageInit(true)) return 1;
+
+    // Rows like the workout log's, rolled and compacted as on the device
+    char row[96];
+    uint32_t rows = 0;
+    StorageStats st;
+    do {
+        snprintf(row, sizeof(row), "2026-10-%02u,%02u:%02u:%02u,Back Squat,%u,%u,%u,%u\n",
+                 1 + rows / 4000 % 28, rows / 600 % 24, rows / 10 % 60, rows % 60,
+                 1 + rows % 5, 1 + rows % 12, 400 + rows % 700, 250 + rows % 400);
+        storageLogAppend(kHeader, row);
+        rows++;
+        hostAdvanceMs(STORAGE_MAINT_INTERVAL_MS);
+        storageMaintain();
+        storageGetStats(&st);
+    } while (st.logBytes < LOG_TARGET_BYTES);
+    hostSerialQuiet = false;
+
+    Sink legacy = {0, 0}, cursor = {0, 0};
+    uint64_t legacyAllocs = 0, cursorAllocs = 0;
+    double legacyS = 0, cursorS = 0;
+
+    for (int run = 0; run < RUNS; run++) {
+        legacy = {0, 0};
+        uint64_t allocs = hostAllocCount;
+        auto start = std::chrono::steady_clock::now();
+        legacyForEachLine(&legacy);
+        legacyS += seconds(start);
+        legacyAllocs = hostAllocCount - allocs;
+
+        cursor = {0, 0};
+        allocs = hostAllocCount;
+        start = std::chrono::steady_clock::now();
+        storageLogForEachLine(cursorLine, &cursor);
+        cursorS += seconds(start);
+        cursorAllocs = hostAllocCount - allocs;
+    }
+
+    double mb = cursor.bytes / (1024.0 * 1024.0);
+    printf("storage_bench: %lu KB log in %u segments + active file, %lu lines\n",
+           (unsigned long)(st.logBytes / 1024), st.segments, (unsigned long)cursor.rows);
+    printf("  String per line: %10lu allocations, %7.1f MB/s host CPU\n",
+           (unsigned long)legacyAllocs, mb * RUNS / legacyS);
+    printf("  cursor views:    %10lu allocations, %7.1f MB/s host CPU\n",
+           (unsigned long)cursorAllocs, mb * RUNS / cursorS);
+
+    bool ok = true;
+    if (legacy.rows != cursor.rows || legacy.bytes != cursor.bytes) {
+        printf("storage_bench: paths disagree (%lu/%lu rows, %lu/%lu bytes)\n",
+               (unsigned long)legacy.rows, (unsigned long)cursor.rows,
+               (unsigned long)legacy.bytes, (unsigned long)cursor.bytes);
+        ok = false;
+    }
+    if (cursorAllocs != 0) {
+        printf("storage_bench: cursor path allocated\n");
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+// Host stand-in for the parts of the Arduino core the firmware uses. Only
+// what the host tests build against; see host.h for the test-side hooks.
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <memory>
+#include "freertos/FreeRTOS.h"
+
+typedef unsigned int uint;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define RISING 1
+#define FALLING 2
+#define CHANGE 3
+#define PROGMEM
+#define IRAM_ATTR
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+using std::max;
+using std::min;
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax) {
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+// Time comes from the host clock in host.h, which tests move by hand
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+int digitalPinToInterrupt(int pin);
+void attachInterrupt(uint8_t irq, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t irq);
+
+// Heap string that grows by exactly what is appended, like the core's, so
+// allocation counts match the device
+class String {
+public:
+    String(const char* s = "");
+    String(const String& other);
+    String(String&& other) noexcept;
+    ~String();
+    String& operator=(const String& other);
+    String& operator=(String&& other) noexcept;
+
+    unsigned length() const { return _len; }
+    const char* c_str() const { return _buf ? _buf : ""; }
+
+    String& operator+=(char c);
+    String& operator+=(const char* s);
+    String& operator+=(const String& s) { return *this += s.c_str(); }
+    bool operator==(const char* s) const { return strcmp(c_str(), s) == 0; }
+
+private:
+    void append(const char* s, size_t n);
+    char* _buf = nullptr;
+    unsigned _len = 0;
+};
+
+String operator+(const String& a, const char* b);
+String operator+(const String& a, const String& b);
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t len);
+    size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+
+    size_t print(const char* s) { return write(s); }
+    size_t print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int n);
+    size_t print(unsigned n);
+    size_t print(long n);
+    size_t print(unsigned long n);
+    size_t print(double n, int digits = 2);
+    size_t println() { return write("\n"); }
+    template <typename T> size_t println(T v) { return print(v) + println(); }
+    size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+    void flush() {}
+};
+
+// Stdout, unless host.h's hostSerialQuiet is set
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long) {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buf, size_t len) override;
+    using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,141 @@
+// Host stand-in for the parts of Arduino_GFX the display code uses: the
+// data bus interface, the ST7789 driver and canvases, with the library's
+// rounded-rectangle and line algorithms so shapes land on the same pixels.
+//
+// Two simplifications, both visible in screenshots and byte counts:
+// - Text uses the classic 6x8 cell, but glyphs are placeholders (a pattern
+//   made from the character code), so text shows where and how big it is
+//   drawn, not what it says.
+// - The ST7789 sends CASET and RASET for every primitive; the library skips
+//   them when the window did not change, so the device sends a little less.
+#ifndef HOST_ARDUINO_GFX_H
+#define HOST_ARDUINO_GFX_H
+
+#include <Arduino.h>
+
+#define GFX_NOT_DEFINED       -1
+#define GFX_SKIP_OUTPUT_BEGIN -2
+
+class Arduino_DataBus {
+public:
+    virtual ~Arduino_DataBus() {}
+
+    virtual bool begin(int32_t speed = GFX_NOT_DEFINED, int8_t dataMode = GFX_NOT_DEFINED) = 0;
+    virtual void beginWrite() = 0;
+    virtual void endWrite() = 0;
+    virtual void writeCommand(uint8_t c) = 0;
+    virtual void writeCommand16(uint16_t c) = 0;
+    virtual void writeCommandBytes(uint8_t *data, uint32_t len) = 0;
+    virtual void write(uint8_t d) = 0;
+    virtual void write16(uint16_t d) = 0;
+    virtual void writeRepeat(uint16_t p, uint32_t len) = 0;
+    virtual void writePixels(uint16_t *data, uint32_t len) = 0;
+    virtual void writeBytes(uint8_t *data, uint32_t len) = 0;
+    virtual void writeIndexedPixels(uint8_t *data, uint16_t *idx, uint32_t len) = 0;
+    virtual void writeIndexedPixelsDouble(uint8_t *data, uint16_t *idx, uint32_t len) = 0;
+
+    virtual void writeC8D8(uint8_t c, uint8_t d);
+    virtual void writeC8D16D16(uint8_t c, uint16_t d1, uint16_t d2);
+};
+
+class Arduino_G {
+public:
+    Arduino_G(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h) {}
+    virtual ~Arduino_G() {}
+
+    virtual bool begin(int32_t speed = GFX_NOT_DEFINED) = 0;
+    virtual void draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) = 0;
+
+protected:
+    int16_t WIDTH, HEIGHT;
+};
+
+class Arduino_GFX : public Print, public Arduino_G {
+public:
+    Arduino_GFX(int16_t w, int16_t h);
+
+    // Every primitive ends up here, already clipped
+    virtual void writeFillRectPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) = 0;
+    virtual void startWrite() {}
+    virtual void endWrite() {}
+
+    void fillScreen(uint16_t color);
+    void drawPixel(int16_t x, int16_t y, uint16_t color);
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color);
+    void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color);
+    void drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color);
+    void fillCircle(int16_t x, int16_t y, int16_t r, uint16_t color);
+    void drawCircle(int16_t x, int16_t y, int16_t r, uint16_t color);
+
+    void setCursor(int16_t x, int16_t y) { _cursorX = x; _cursorY = y; }
+    void setTextSize(uint8_t size) { _textSize = size ? size : 1; }
+    void setTextColor(uint16_t c) { _textColor = _textBg = c; }
+    void setTextColor(uint16_t c, uint16_t bg) { _textColor = c; _textBg = bg; }
+    void setTextWrap(bool wrap) { _wrap = wrap; }
+    void getTextBounds(const char *str, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h);
+
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+
+protected:
+    void drawChar(int16_t x, int16_t y, unsigned char c);
+    void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t color);
+    void drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, uint16_t color);
+
+    int16_t _width, _height;
+    int16_t _cursorX = 0, _cursorY = 0;
+    uint8_t _textSize = 1;
+    uint16_t _textColor = 0xFFFF, _textBg = 0xFFFF;
+    bool _wrap = true;
+};
+
+// Rotation 0 only; the offsets move the window in panel memory
+class Arduino_ST7789 : public Arduino_GFX {
+public:
+    Arduino_ST7789(Arduino_DataBus *bus, int8_t rst = GFX_NOT_DEFINED, uint8_t r = 0, bool ips = false,
+                   int16_t w = 240, int16_t h = 320, uint8_t col_offset1 = 0, uint8_t row_offset1 = 0,
+                   uint8_t col_offset2 = 0, uint8_t row_offset2 = 0);
+
+    bool begin(int32_t speed = GFX_NOT_DEFINED) override;
+    void writeFillRectPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) override;
+    void startWrite() override { _bus->beginWrite(); }
+    void endWrite() override { _bus->endWrite(); }
+
+    void writeAddrWindow(int16_t x, int16_t y, uint16_t w, uint16_t h);
+    void displayOn();
+    void displayOff();
+    void invertDisplay(bool invert);
+
+private:
+    Arduino_DataBus *_bus;
+    bool _ips;
+    int16_t _xStart, _yStart;
+};
+
+class Arduino_Canvas : public Arduino_GFX {
+public:
+    Arduino_Canvas(int16_t w, int16_t h, Arduino_G *output, int16_t output_x = 0, int16_t output_y = 0,
+                   uint8_t rotation = 0);
+    ~Arduino_Canvas();
+
+    bool begin(int32_t speed = GFX_NOT_DEFINED) override;
+    void writeFillRectPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) override;
+    uint16_t *getFramebuffer() { return _framebuffer; }
+    void flush();
+
+private:
+    uint16_t *_framebuffer = nullptr;
+    Arduino_G *_output;
+    int16_t _outputX, _outputY;
+};
+
+#endif // HOST_ARDUINO_GFX_H
@@ -0,0 +1,44 @@
+// Host stand-in for the core's File, backed by LittleFS.h's in-memory
+// filesystem
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct HostFsNode;
+
+class File : public Print {
+public:
+    File() {}
+    File(std::shared_ptr<HostFsNode> node, const std::string& path, bool append);
+
+    explicit operator bool() const { return (bool)_node; }
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buf, size_t len) override;
+    using Print::write;
+
+    int available();
+    int read();
+    int read(uint8_t* buf, size_t len);
+    int peek();
+    bool seek(uint32_t pos);
+    size_t position() const { return _pos; }
+    size_t size() const;
+    const char* name() const;
+    const char* path() const { return _path.c_str(); }
+    bool isDirectory() const;
+    File openNextFile();
+    String readStringUntil(char terminator);
+    void close() { _node.reset(); }
+
+private:
+    std::shared_ptr<HostFsNode> _node;
+    std::string _path;
+    size_t _pos = 0;
+    size_t _nextChild = 0;   // Directories: openNextFile() position
+};
+
+#endif // HOST_FS_H
@@ -0,0 +1,23 @@
+// Host stand-in for LittleFS: files live in memory for the life of the test
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+#include <FS.h>
+
+class LittleFSFS {
+public:
+    bool begin(bool formatOnFail = false, const char* basePath = "/littlefs", uint8_t maxOpenFiles = 10,
+               const char* label = "spiffs");
+    void end() {}
+    bool exists(const char* path);
+    bool remove(const char* path);
+    bool rename(const char* from, const char* to);
+    bool mkdir(const char* path);
+    File open(const char* path, const char* mode = "r", bool create = false);
+    size_t totalBytes();
+    size_t usedBytes();
+};
+
+extern LittleFSFS LittleFS;
+
+#endif // HOST_LITTLEFS_H
@@ -0,0 +1,31 @@
+// Host stand-in for the core's TwoWire. Transactions go to the fake
+// devices a test attaches with hostI2cAttach() (host.h); an address with
+// none attached NACKs.
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire {
+public:
+    bool begin(int = -1, int = -1, uint32_t = 0) { return true; }
+    void setClock(uint32_t) {}
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t* data, size_t len);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t len, bool sendStop = true);
+    int available() { return _rxLen - _rxPos; }
+    int read() { return _rxPos < _rxLen ? _rx[_rxPos++] : -1; }
+
+private:
+    uint8_t _address = 0;
+    uint8_t _tx[64];
+    size_t _txLen = 0;
+    uint8_t _rx[64];
+    int _rxLen = 0, _rxPos = 0;
+};
+
+extern TwoWire Wire;
+
+#endif // HOST_WIRE_H
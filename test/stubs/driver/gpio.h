@@ -0,0 +1,7 @@
+// Host stand-in for ESP-IDF's GPIO driver header
+#ifndef HOST_DRIVER_GPIO_H
+#define HOST_DRIVER_GPIO_H
+
+typedef int gpio_num_t;
+
+#endif // HOST_DRIVER_GPIO_H
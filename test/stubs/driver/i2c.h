@@ -0,0 +1,10 @@
+// Host stand-in for ESP-IDF's legacy I2C driver header: only the types
+// (the firmware talks I2C through Wire)
+#ifndef HOST_DRIVER_I2C_H
+#define HOST_DRIVER_I2C_H
+
+typedef int i2c_port_t;
+
+#define I2C_NUM_0 0
+
+#endif // HOST_DRIVER_I2C_H
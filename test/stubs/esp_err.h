@@ -0,0 +1,19 @@
+// Host stand-in for ESP-IDF's esp_err.h
+#ifndef HOST_ESP_ERR_H
+#define HOST_ESP_ERR_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef int esp_err_t;
+
+#define ESP_OK              0
+#define ESP_FAIL            -1
+#define ESP_ERR_INVALID_ARG 0x102
+
+#define ESP_ERROR_CHECK(x) do { \
+    esp_err_t err_ = (x); \
+    if (err_ != ESP_OK) { printf("ESP_ERROR_CHECK failed: %d at %s:%d\n", err_, __FILE__, __LINE__); abort(); } \
+} while (0)
+
+#endif // HOST_ESP_ERR_H
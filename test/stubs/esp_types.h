@@ -0,0 +1,11 @@
+// Host stand-in for ESP-IDF's esp_types.h
+#ifndef HOST_ESP_TYPES_H
+#define HOST_ESP_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define BIT(n) (1UL << (n))
+
+#endif // HOST_ESP_TYPES_H
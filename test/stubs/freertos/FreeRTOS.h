@@ -0,0 +1,14 @@
+// Host stand-in for the FreeRTOS bits the firmware uses outside tasks.
+// vTaskDelay() advances the fake clock like delay().
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+void vTaskDelay(TickType_t ticks);
+
+#endif // HOST_FREERTOS_H
@@ -0,0 +1,48 @@
+// Test-side hooks into the host Arduino layer
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdint.h>
+
+// The clock behind millis()/micros(); delay() moves it too
+extern uint64_t hostNowUs;
+static inline void hostAdvanceMs(uint32_t ms) { hostNowUs += (uint64_t)ms * 1000; }
+
+// Drop Serial output (benchmarks, noisy loops)
+extern bool hostSerialQuiet;
+
+// Heap allocations made through operator new since start, when the test
+// links host_alloc.cpp (see CMakeLists.txt)
+extern uint64_t hostAllocCount;
+extern uint64_t hostAllocBytes;
+
+// Non-zero while the host layer does its own bookkeeping (the in-memory
+// filesystem's paths), which a device would not allocate for
+extern int hostAllocPaused;
+struct HostAllocPause {
+    HostAllocPause() { hostAllocPaused++; }
+    ~HostAllocPause() { hostAllocPaused--; }
+};
+
+// Pin interrupts: attachInterrupt() handlers, fired by the test
+void hostFireIrq(int pin);
+
+// A fake I2C device. write() gets each transaction's bytes and returns
+// false to NACK it; read() fills a requestFrom()
+class HostI2cDevice {
+public:
+    virtual ~HostI2cDevice() {}
+    virtual bool write(const uint8_t* data, size_t len) = 0;
+    virtual size_t read(uint8_t* out, size_t len) = 0;
+};
+
+void hostI2cAttach(uint8_t address, HostI2cDevice* device);
+
+// Transactions (a write, or a read) since start, acknowledged or not
+extern uint32_t hostI2cWrites;
+extern uint32_t hostI2cReads;
+
+// In-memory LittleFS: capacity reported by totalBytes(), and a wipe
+void hostFsReset(size_t totalBytes);
+
+#endif // HOST_H
@@ -0,0 +1,25 @@
+// Counting operator new for the benchmarks (not the sanitizer builds,
+// which replace the allocator themselves)
+
+#include <new>
+#include <stdlib.h>
+#include "host.h"
+
+uint64_t hostAllocCount = 0;
+uint64_t hostAllocBytes = 0;
+
+void* operator new(size_t size) {
+    if (!hostAllocPaused) {
+        hostAllocCount++;
+        hostAllocBytes += size;
+    }
+    void* p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
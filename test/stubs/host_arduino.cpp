@@ -0,0 +1,310 @@
+// Host Arduino layer: clock, pins, String, Print, Serial and an in-memory
+// LittleFS. Built into every host test that includes firmware sources.
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <Wire.h>
+#include <map>
+#include "host.h"
+
+uint64_t hostNowUs = 0;
+bool hostSerialQuiet = false;
+int hostAllocPaused = 0;
+
+unsigned long millis() { return (unsigned long)(hostNowUs / 1000); }
+unsigned long micros() { return (unsigned long)hostNowUs; }
+void delay(unsigned long ms) { hostNowUs += (uint64_t)ms * 1000; }
+void delayMicroseconds(unsigned int us) { hostNowUs += us; }
+void vTaskDelay(TickType_t ticks) { delay(ticks); }
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+void analogWrite(uint8_t, int) {}
+int digitalRead(uint8_t) { return HIGH; }
+int digitalPinToInterrupt(int pin) { return pin; }
+
+static void (*irqHandlers[64])(void);
+void attachInterrupt(uint8_t irq, void (*isr)(void), int) { irqHandlers[irq & 63] = isr; }
+void detachInterrupt(uint8_t irq) { irqHandlers[irq & 63] = nullptr; }
+
+void hostFireIrq(int pin) {
+    if (irqHandlers[pin & 63]) irqHandlers[pin & 63]();
+}
+
+// ---- I2C ----
+
+static HostI2cDevice* i2cDevices[128];
+uint32_t hostI2cWrites = 0;
+uint32_t hostI2cReads = 0;
+TwoWire Wire;
+
+void hostI2cAttach(uint8_t address, HostI2cDevice* device) { i2cDevices[address & 127] = device; }
+
+void TwoWire::beginTransmission(uint8_t address) {
+    _address = address;
+    _txLen = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (_txLen == sizeof(_tx)) return 0;
+    _tx[_txLen++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t len) {
+    size_t n = 0;
+    while (n < len && write(data[n])) n++;
+    return n;
+}
+
+// 0 = ACK, 2 = address NACK, as the core reports them
+uint8_t TwoWire::endTransmission(bool) {
+    hostI2cWrites++;
+    HostI2cDevice* dev = i2cDevices[_address & 127];
+    return dev && dev->write(_tx, _txLen) ? 0 : 2;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t len, bool) {
+    hostI2cReads++;
+    HostI2cDevice* dev = i2cDevices[address & 127];
+    _rxPos = 0;
+    _rxLen = dev ? (int)dev->read(_rx, std::min((size_t)len, sizeof(_rx))) : 0;
+    return (uint8_t)_rxLen;
+}
+
+// ---- String ----
+
+String::String(const char* s) { append(s, strlen(s)); }
+String::String(const String& other) { append(other.c_str(), other._len); }
+String::String(String&& other) noexcept : _buf(other._buf), _len(other._len) {
+    other._buf = nullptr;
+    other._len = 0;
+}
+String::~String() { delete[] _buf; }
+
+String& String::operator=(const String& other) {
+    if (this != &other) {
+        delete[] _buf;
+        _buf = nullptr;
+        _len = 0;
+        append(other.c_str(), other._len);
+    }
+    return *this;
+}
+
+String& String::operator=(String&& other) noexcept {
+    std::swap(_buf, other._buf);
+    std::swap(_len, other._len);
+    return *this;
+}
+
+String& String::operator+=(char c) {
+    append(&c, 1);
+    return *this;
+}
+
+String& String::operator+=(const char* s) {
+    append(s, strlen(s));
+    return *this;
+}
+
+void String::append(const char* s, size_t n) {
+    if (n == 0 && _buf) return;
+    char* buf = new char[_len + n + 1];
+    if (_buf) memcpy(buf, _buf, _len);
+    memcpy(buf + _len, s, n);
+    _len += n;
+    buf[_len] = '\0';
+    delete[] _buf;
+    _buf = buf;
+}
+
+String operator+(const String& a, const char* b) {
+    String s(a);
+    s += b;
+    return s;
+}
+
+String operator+(const String& a, const String& b) { return a + b.c_str(); }
+
+// ---- Print / Serial ----
+
+size_t Print::write(const uint8_t* buf, size_t len) {
+    size_t n = 0;
+    while (len--) n += write(*buf++);
+    return n;
+}
+
+size_t Print::print(int n) { return printf("%d", n); }
+size_t Print::print(unsigned n) { return printf("%u", n); }
+size_t Print::print(long n) { return printf("%ld", n); }
+size_t Print::print(unsigned long n) { return printf("%lu", n); }
+size_t Print::print(double n, int digits) { return printf("%.*f", digits, n); }
+
+size_t Print::printf(const char* fmt, ...) {
+    char small[256];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(small, sizeof(small), fmt, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if ((size_t)len < sizeof(small)) return write((const uint8_t*)small, len);
+
+    std::unique_ptr<char[]> big(new char[len + 1]);
+    va_start(args, fmt);
+    vsnprintf(big.get(), len + 1, fmt, args);
+    va_end(args);
+    return write((const uint8_t*)big.get(), len);
+}
+
+HardwareSerial Serial;
+
+size_t HardwareSerial::write(uint8_t c) { return write(&c, 1); }
+
+size_t HardwareSerial::write(const uint8_t* buf, size_t len) {
+    if (!hostSerialQuiet) fwrite(buf, 1, len, stdout);
+    return len;
+}
+
+// ---- In-memory LittleFS ----
+
+struct HostFsNode {
+    bool dir = false;
+    std::vector<uint8_t> data;
+};
+
+static std::map<std::string, std::shared_ptr<HostFsNode>> fsNodes;
+static size_t fsTotalBytes = 1024 * 1024;
+LittleFSFS LittleFS;
+
+void hostFsReset(size_t totalBytes) {
+    fsNodes.clear();
+    fsTotalBytes = totalBytes;
+}
+
+File::File(std::shared_ptr<HostFsNode> node, const std::string& path, bool append)
+    : _node(node), _path(path), _pos(append ? node->data.size() : 0) {}
+
+size_t File::write(const uint8_t* buf, size_t len) {
+    if (!_node || _node->dir) return 0;
+    std::vector<uint8_t>& d = _node->data;
+    if (_pos + len > d.size()) d.resize(_pos + len);
+    memcpy(d.data() + _pos, buf, len);
+    _pos += len;
+    return len;
+}
+
+int File::available() { return _node && !_node->dir ? (int)(_node->data.size() - _pos) : 0; }
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::read(uint8_t* buf, size_t len) {
+    size_t n = std::min(len, (size_t)available());
+    if (n) memcpy(buf, _node->data.data() + _pos, n);
+    _pos += n;
+    return (int)n;
+}
+
+int File::peek() { return available() ? _node->data[_pos] : -1; }
+
+bool File::seek(uint32_t pos) {
+    if (!_node || pos > _node->data.size()) return false;
+    _pos = pos;
+    return true;
+}
+
+size_t File::size() const { return _node ? _node->data.size() : 0; }
+
+const char* File::name() const {
+    const char* slash = strrchr(_path.c_str(), '/');
+    return slash ? slash + 1 : _path.c_str();
+}
+
+bool File::isDirectory() const { return _node && _node->dir; }
+
+File File::openNextFile() {
+    HostAllocPause pause;
+    if (!isDirectory()) return File();
+    std::string prefix = _path + "/";
+    size_t i = 0;
+    for (auto& kv : fsNodes) {
+        const std::string& p = kv.first;
+        if (p.compare(0, prefix.size(), prefix) != 0 || p.find('/', prefix.size()) != std::string::npos) continue;
+        if (i++ == _nextChild) {
+            _nextChild++;
+            return File(kv.second, p, false);
+        }
+    }
+    return File();
+}
+
+// Grows one character at a time, as the core's Stream version does
+String File::readStringUntil(char terminator) {
+    String s;
+    int c;
+    while ((c = read()) >= 0 && c != terminator) s += (char)c;
+    return s;
+}
+
+bool LittleFSFS::begin(bool, const char*, uint8_t, const char*) {
+    if (!fsNodes.count("")) fsNodes[""] = std::make_shared<HostFsNode>();
+    fsNodes[""]->dir = true;
+    return true;
+}
+
+static std::string fsKey(const char* path) {
+    std::string p = path;
+    while (p.size() > 1 && p.back() == '/') p.pop_back();
+    return p == "/" ? "" : p;
+}
+
+bool LittleFSFS::exists(const char* path) {
+    HostAllocPause pause;
+    return fsNodes.count(fsKey(path)) > 0;
+}
+
+bool LittleFSFS::remove(const char* path) {
+    HostAllocPause pause;
+    return fsNodes.erase(fsKey(path)) > 0;
+}
+
+bool LittleFSFS::rename(const char* from, const char* to) {
+    HostAllocPause pause;
+    auto it = fsNodes.find(fsKey(from));
+    if (it == fsNodes.end()) return false;
+    auto node = it->second;
+    fsNodes.erase(it);
+    fsNodes[fsKey(to)] = node;
+    return true;
+}
+
+bool LittleFSFS::mkdir(const char* path) {
+    auto& node = fsNodes[fsKey(path)];
+    if (!node) node = std::make_shared<HostFsNode>();
+    node->dir = true;
+    return true;
+}
+
+File LittleFSFS::open(const char* path, const char* mode, bool) {
+    HostAllocPause pause;
+    std::string key = fsKey(path);
+    auto it = fsNodes.find(key);
+    if (mode[0] == 'r') return it == fsNodes.end() ? File() : File(it->second, key, false);
+
+    if (it == fsNodes.end()) it = fsNodes.emplace(key, std::make_shared<HostFsNode>()).first;
+    if (it->second->dir) return File();
+    if (mode[0] == 'w') it->second->data.clear();
+    return File(it->second, key, mode[0] == 'a');
+}
+
+size_t LittleFSFS::totalBytes() { return fsTotalBytes; }
+
+// Whole 4 KB blocks per file, plus two for the superblock
+size_t LittleFSFS::usedBytes() {
+    size_t used = 2 * 4096;
+    for (auto& kv : fsNodes) used += (kv.second->data.size() + 4095) / 4096 * 4096;
+    return used;
+}
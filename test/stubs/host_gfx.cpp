@@ -0,0 +1,341 @@
+// Arduino_GFX stand-in (see Arduino_GFX_Library.h)
+
+#include <Arduino_GFX_Library.h>
+
+// MIPI DCS commands the ST7789 setup and windows use
+#define ST7789_SWRESET 0x01
+#define ST7789_SLPOUT  0x11
+#define ST7789_INVOFF  0x20
+#define ST7789_INVON   0x21
+#define ST7789_DISPOFF 0x28
+#define ST7789_DISPON  0x29
+#define ST7789_CASET   0x2A
+#define ST7789_RASET   0x2B
+#define ST7789_RAMWR   0x2C
+#define ST7789_MADCTL  0x36
+#define ST7789_COLMOD  0x3A
+
+// ============== Data bus ==============
+
+void Arduino_DataBus::writeC8D8(uint8_t c, uint8_t d) {
+    writeCommand(c);
+    write(d);
+}
+
+void Arduino_DataBus::writeC8D16D16(uint8_t c, uint16_t d1, uint16_t d2) {
+    writeCommand(c);
+    write16(d1);
+    write16(d2);
+}
+
+// ============== Primitives ==============
+
+Arduino_GFX::Arduino_GFX(int16_t w, int16_t h) : Arduino_G(w, h), _width(w), _height(h) {}
+
+void Arduino_GFX::fillScreen(uint16_t color) {
+    fillRect(0, 0, _width, _height, color);
+}
+
+void Arduino_GFX::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    fillRect(x, y, 1, 1, color);
+}
+
+void Arduino_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (w < 0) { x += w + 1; w = -w; }
+    if (h < 0) { y += h + 1; h = -h; }
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > _width) w = _width - x;
+    if (y + h > _height) h = _height - y;
+    if (w <= 0 || h <= 0) return;
+
+    startWrite();
+    writeFillRectPreclipped(x, y, w, h, color);
+    endWrite();
+}
+
+void Arduino_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+}
+
+void Arduino_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    fillRect(x, y, w, 1, color);
+}
+
+void Arduino_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    fillRect(x, y, 1, h, color);
+}
+
+void Arduino_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    if (x0 == x1) {
+        drawFastVLine(x0, min(y0, y1), abs(y1 - y0) + 1, color);
+        return;
+    }
+    if (y0 == y1) {
+        drawFastHLine(min(x0, x1), y0, abs(x1 - x0) + 1, color);
+        return;
+    }
+
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+        std::swap(x0, y0);
+        std::swap(x1, y1);
+    }
+    if (x0 > x1) {
+        std::swap(x0, x1);
+        std::swap(y0, y1);
+    }
+    int16_t dx = x1 - x0, dy = abs(y1 - y0);
+    int16_t err = dx / 2, ystep = y0 < y1 ? 1 : -1;
+    for (; x0 <= x1; x0++) {
+        if (steep) drawPixel(y0, x0, color);
+        else drawPixel(x0, y0, color);
+        err -= dy;
+        if (err < 0) {
+            y0 += ystep;
+            err += dx;
+        }
+    }
+}
+
+// Quarter circles, as the library draws them: corners 1 top left,
+// 2 top right, 4 bottom right, 8 bottom left
+void Arduino_GFX::drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, uint16_t color) {
+    int16_t f = 1 - r, ddFx = 1, ddFy = -2 * r, x = 0, y = r;
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddFy += 2;
+            f += ddFy;
+        }
+        x++;
+        ddFx += 2;
+        f += ddFx;
+        if (corners & 4) { drawPixel(x0 + x, y0 + y, color); drawPixel(x0 + y, y0 + x, color); }
+        if (corners & 2) { drawPixel(x0 + x, y0 - y, color); drawPixel(x0 + y, y0 - x, color); }
+        if (corners & 8) { drawPixel(x0 - y, y0 + x, color); drawPixel(x0 - x, y0 + y, color); }
+        if (corners & 1) { drawPixel(x0 - y, y0 - x, color); drawPixel(x0 - x, y0 - y, color); }
+    }
+}
+
+// Halves of a filled circle stretched by delta rows: corners 1 right, 2 left
+void Arduino_GFX::fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta,
+                                   uint16_t color) {
+    int16_t f = 1 - r, ddFx = 1, ddFy = -2 * r, x = 0, y = r, px = x, py = y;
+    delta++;
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddFy += 2;
+            f += ddFy;
+        }
+        x++;
+        ddFx += 2;
+        f += ddFx;
+        if (x < y + 1) {
+            if (corners & 1) drawFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
+            if (corners & 2) drawFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+        }
+        if (y != py) {
+            if (corners & 1) drawFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
+            if (corners & 2) drawFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+            py = y;
+        }
+        px = x;
+    }
+}
+
+void Arduino_GFX::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+    int16_t maxRadius = (w < h ? w : h) / 2;
+    if (r > maxRadius) r = maxRadius;
+    fillRect(x + r, y, w - 2 * r, h, color);
+    fillCircleHelper(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
+    fillCircleHelper(x + r, y + r, r, 2, h - 2 * r - 1, color);
+}
+
+void Arduino_GFX::drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+    int16_t maxRadius = (w < h ? w : h) / 2;
+    if (r > maxRadius) r = maxRadius;
+    drawFastHLine(x + r, y, w - 2 * r, color);
+    drawFastHLine(x + r, y + h - 1, w - 2 * r, color);
+    drawFastVLine(x, y + r, h - 2 * r, color);
+    drawFastVLine(x + w - 1, y + r, h - 2 * r, color);
+    drawCircleHelper(x + r, y + r, r, 1, color);
+    drawCircleHelper(x + w - r - 1, y + r, r, 2, color);
+    drawCircleHelper(x + w - r - 1, y + h - r - 1, r, 4, color);
+    drawCircleHelper(x + r, y + h - r - 1, r, 8, color);
+}
+
+void Arduino_GFX::fillCircle(int16_t x, int16_t y, int16_t r, uint16_t color) {
+    drawFastVLine(x, y - r, 2 * r + 1, color);
+    fillCircleHelper(x, y, r, 3, 0, color);
+}
+
+void Arduino_GFX::drawCircle(int16_t x, int16_t y, int16_t r, uint16_t color) {
+    drawPixel(x, y + r, color);
+    drawPixel(x, y - r, color);
+    drawPixel(x + r, y, color);
+    drawPixel(x - r, y, color);
+    drawCircleHelper(x, y, r, 15, color);
+}
+
+// ============== Text ==============
+
+// Placeholder glyph rows (5 bits each) for a character: a frame with a
+// pattern inside, different per character
+static uint8_t glyphRow(unsigned char c, uint8_t row) {
+    if (c == ' ') return 0;
+    if (row == 0 || row == 6) return 0x1F;
+    uint32_t h = c * 2654435761u;
+    return 0x11 | ((h >> (row * 5)) & 0x0E);
+}
+
+void Arduino_GFX::drawChar(int16_t x, int16_t y, unsigned char c) {
+    for (uint8_t row = 0; row < 8; row++) {
+        uint8_t bits = row < 7 ? glyphRow(c, row) : 0;
+        for (uint8_t col = 0; col < 6; col++) {
+            bool on = col < 5 && (bits & (0x10 >> col));
+            if (on) fillRect(x + col * _textSize, y + row * _textSize, _textSize, _textSize, _textColor);
+            else if (_textBg != _textColor) fillRect(x + col * _textSize, y + row * _textSize, _textSize, _textSize, _textBg);
+        }
+    }
+}
+
+size_t Arduino_GFX::write(uint8_t c) {
+    if (c == '\n') {
+        _cursorX = 0;
+        _cursorY += _textSize * 8;
+    } else if (c != '\r') {
+        if (_wrap && _cursorX + _textSize * 6 > _width) {
+            _cursorX = 0;
+            _cursorY += _textSize * 8;
+        }
+        drawChar(_cursorX, _cursorY, c);
+        _cursorX += _textSize * 6;
+    }
+    return 1;
+}
+
+void Arduino_GFX::getTextBounds(const char *str, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w,
+                                uint16_t *h) {
+    int16_t cx = x, cy = y, maxX = x - 1, maxY = y - 1;
+    for (; *str; str++) {
+        if (*str == '\n') {
+            cx = 0;
+            cy += _textSize * 8;
+            continue;
+        }
+        if (*str == '\r') continue;
+        if (_wrap && cx + _textSize * 6 > _width) {
+            cx = 0;
+            cy += _textSize * 8;
+        }
+        maxX = max<int16_t>(maxX, cx + _textSize * 6 - 1);
+        maxY = max<int16_t>(maxY, cy + _textSize * 8 - 1);
+        cx += _textSize * 6;
+    }
+    *x1 = x;
+    *y1 = y;
+    *w = maxX >= x ? maxX - x + 1 : 0;
+    *h = maxY >= y ? maxY - y + 1 : 0;
+}
+
+// ============== ST7789 ==============
+
+Arduino_ST7789::Arduino_ST7789(Arduino_DataBus *bus, int8_t, uint8_t, bool ips, int16_t w, int16_t h,
+                               uint8_t col_offset1, uint8_t row_offset1, uint8_t, uint8_t)
+    : Arduino_GFX(w, h), _bus(bus), _ips(ips), _xStart(col_offset1), _yStart(row_offset1) {}
+
+bool Arduino_ST7789::begin(int32_t speed) {
+    if (!_bus->begin(speed)) return false;
+
+    _bus->beginWrite();
+    _bus->writeCommand(ST7789_SWRESET);
+    _bus->writeCommand(ST7789_SLPOUT);
+    _bus->writeC8D8(ST7789_COLMOD, 0x55);
+    _bus->writeC8D8(ST7789_MADCTL, 0x00);
+    _bus->writeCommand(_ips ? ST7789_INVON : ST7789_INVOFF);
+    _bus->writeCommand(ST7789_DISPON);
+    _bus->endWrite();
+    return true;
+}
+
+void Arduino_ST7789::writeAddrWindow(int16_t x, int16_t y, uint16_t w, uint16_t h) {
+    _bus->writeC8D16D16(ST7789_CASET, x + _xStart, x + _xStart + w - 1);
+    _bus->writeC8D16D16(ST7789_RASET, y + _yStart, y + _yStart + h - 1);
+    _bus->writeCommand(ST7789_RAMWR);
+}
+
+void Arduino_ST7789::writeFillRectPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    writeAddrWindow(x, y, w, h);
+    _bus->writeRepeat(color, (uint32_t)w * h);
+}
+
+void Arduino_ST7789::draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) {
+    if (x < 0 || y < 0 || x + w > _width || y + h > _height) {
+        // Clipped: row by row
+        for (int16_t j = 0; j < h; j++) {
+            for (int16_t i = 0; i < w; i++) drawPixel(x + i, y + j, bitmap[(int32_t)j * w + i]);
+        }
+        return;
+    }
+    _bus->beginWrite();
+    writeAddrWindow(x, y, w, h);
+    _bus->writePixels(bitmap, (uint32_t)w * h);
+    _bus->endWrite();
+}
+
+void Arduino_ST7789::displayOn() {
+    _bus->beginWrite();
+    _bus->writeCommand(ST7789_DISPON);
+    _bus->endWrite();
+}
+
+void Arduino_ST7789::displayOff() {
+    _bus->beginWrite();
+    _bus->writeCommand(ST7789_DISPOFF);
+    _bus->endWrite();
+}
+
+void Arduino_ST7789::invertDisplay(bool invert) {
+    _bus->beginWrite();
+    _bus->writeCommand(_ips ^ invert ? ST7789_INVON : ST7789_INVOFF);
+    _bus->endWrite();
+}
+
+// ============== Canvas ==============
+
+Arduino_Canvas::Arduino_Canvas(int16_t w, int16_t h, Arduino_G *output, int16_t output_x, int16_t output_y,
+                               uint8_t)
+    : Arduino_GFX(w, h), _output(output), _outputX(output_x), _outputY(output_y) {}
+
+Arduino_Canvas::~Arduino_Canvas() {
+    free(_framebuffer);
+}
+
+bool Arduino_Canvas::begin(int32_t speed) {
+    if (speed != GFX_SKIP_OUTPUT_BEGIN && _output && !_output->begin(speed)) return false;
+    if (!_framebuffer) _framebuffer = (uint16_t *)calloc((size_t)_width * _height, sizeof(uint16_t));
+    return _framebuffer != nullptr;
+}
+
+void Arduino_Canvas::writeFillRectPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if (!_framebuffer) return;
+    for (int16_t j = 0; j < h; j++) {
+        uint16_t *row = _framebuffer + (int32_t)(y + j) * _width + x;
+        for (int16_t i = 0; i < w; i++) row[i] = color;
+    }
+}
+
+void Arduino_Canvas::draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) {
+    for (int16_t j = 0; j < h; j++) {
+        for (int16_t i = 0; i < w; i++) drawPixel(x + i, y + j, bitmap[(int32_t)j * w + i]);
+    }
+}
+
+void Arduino_Canvas::flush() {
+    if (_output && _framebuffer) _output->draw16bitRGBBitmap(_outputX, _outputY, _framebuffer, _width, _height);
+}
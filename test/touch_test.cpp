@@ -0,0 +1,336 @@
+// touch.cpp against a fake CST816 on the host Wire: finger traces go in
+// as controller reports (with the IRQ pulses the chip would give), and
+// the gestures touchUpdate() hands out are checked.
+
+#include "touch.h"
+#include <chrono>
+#include <vector>
+#include "host.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); failures++; } \
+} while (0)
+
+#define TICK_MS 10   // The controller reports about this often while touched
+
+// Register file of a CST816. NACKs the next nacks transactions, as one
+// still starting up does, and register writes while dropWrites is set.
+class FakeCst816 : public HostI2cDevice {
+public:
+    uint8_t regs[256] = {};
+    uint8_t ptr = 0;
+    int nacks = 0;
+    bool dropWrites = false;
+
+    bool write(const uint8_t* data, size_t len) override {
+        if (nacks > 0) {
+            nacks--;
+            return false;
+        }
+        if (dropWrites && len >= 2) return false;
+        if (len >= 1) ptr = data[0];
+        if (len >= 2) regs[ptr] = data[1];
+        return true;
+    }
+
+    size_t read(uint8_t* out, size_t len) override {
+        for (size_t i = 0; i < len; i++) out[i] = regs[(uint8_t)(ptr + i)];
+        return len;
+    }
+
+    bool touched() const { return regs[0x02] != 0; }
+    void set(bool down, int x, int y) {
+        regs[0x02] = down ? 1 : 0;
+        regs[0x03] = (x >> 8) & 0x0F;
+        regs[0x04] = x;
+        regs[0x05] = (y >> 8) & 0x0F;
+        regs[0x06] = y;
+    }
+};
+
+static FakeCst816 chip;
+
+typedef struct {
+    TouchEvent event;
+    TouchInfo info;
+} Seen;
+
+static std::vector<Seen> seen;
+static int fingerX = 0, fingerY = 0;
+
+static void drain() {
+    int16_t x, y;
+    TouchEvent ev;
+    while ((ev = touchUpdate(x, y)) != TOUCH_NONE) {
+        Seen s;
+        s.event = ev;
+        touchGetInfo(&s.info);
+        seen.push_back(s);
+    }
+}
+
+// One controller report period: a pulse while touched, then the loop runs
+static void tick() {
+    hostAdvanceMs(TICK_MS);
+    if (chip.touched()) hostFireIrq(TOUCH_IRQ);
+    drain();
+}
+
+static void press(int x, int y) {
+    fingerX = x;
+    fingerY = y;
+    chip.set(true, x, y);
+    hostFireIrq(TOUCH_IRQ);
+    tick();
+}
+
+static void hold(int ms) {
+    for (int t = 0; t < ms; t += TICK_MS) tick();
+}
+
+static void moveTo(int x, int y, int ms) {
+    int steps = ms / TICK_MS, x0 = fingerX, y0 = fingerY;
+    for (int i = 1; i <= steps; i++) {
+        fingerX = x0 + (x - x0) * i / steps;
+        fingerY = y0 + (y - y0) * i / steps;
+        chip.set(true, fingerX, fingerY);
+        tick();
+    }
+}
+
+// Lift, then wait out the debounce so the next gesture starts clean
+static void release() {
+    chip.set(false, fingerX, fingerY);
+    hostFireIrq(TOUCH_IRQ);
+    hold(DEBOUNCE_MS + 50);
+}
+
+static int count(TouchEvent ev) {
+    int n = 0;
+    for (const Seen& s : seen) n += s.event == ev;
+    return n;
+}
+
+static const Seen* last() { return seen.empty() ? nullptr : &seen.back(); }
+
+static bool onlySteppers(int16_t x, int16_t y) { return x >= 150 && y >= 0; }
+
+#define REG_SLEEP_TIME 0xF9
+#define REG_IRQ_CTL    0xFA
+#define REG_AUTO_SLEEP 0xFE
+
+static void clearConfig() {
+    chip.regs[REG_IRQ_CTL] = 0;
+    chip.regs[REG_SLEEP_TIME] = 0xFF;
+    chip.regs[REG_AUTO_SLEEP] = 0xFF;
+}
+
+static bool configApplied() {
+    return chip.regs[REG_IRQ_CTL] == 0x60 && chip.regs[REG_SLEEP_TIME] == TOUCH_AUTO_SLEEP_S &&
+           chip.regs[REG_AUTO_SLEEP] == 0;
+}
+
+static void testInit() {
+    // Still booting for the first few probes: found once it answers,
+    // TOUCH_PROBE_RETRY_MS apart, and set up for IRQ reporting
+    clearConfig();
+    chip.nacks = 3;
+    unsigned long start = millis();
+    CHECK(touchInit());
+    CHECK(millis() - start >= 3 * TOUCH_PROBE_RETRY_MS);
+    CHECK(chip.nacks == 0);
+    CHECK(configApplied());
+
+    // Absent: gives up after TOUCH_PROBE_TRIES
+    chip.nacks = 1000;
+    CHECK(!touchInit());
+    CHECK(chip.nacks == 1000 - TOUCH_PROBE_TRIES);
+    chip.nacks = 0;
+
+    // Dozed off between the probe and the setup: found, and the setup
+    // goes out with the first good read instead
+    clearConfig();
+    chip.dropWrites = true;
+    CHECK(touchInit());
+    CHECK(!configApplied());
+    chip.dropWrites = false;
+    hostAdvanceMs(1000);
+    press(100, 100);
+    CHECK(configApplied());
+    release();
+    seen.clear();
+}
+
+static void testTap() {
+    seen.clear();
+    press(100, 100);
+    hold(100);
+    release();
+    CHECK(seen.size() == 1 && seen[0].event == TOUCH_TAP);
+    CHECK(seen.size() == 1 && seen[0].info.x == 100 && seen[0].info.y == 100);
+}
+
+static void testDrag() {
+    // Slow and short: drags, then a plain end
+    seen.clear();
+    press(60, 150);
+    moveTo(90, 150, 600);
+    hold(200);
+    release();
+    int dx = 0;
+    for (const Seen& s : seen) {
+        if (s.event == TOUCH_DRAG) {
+            dx += s.info.dx;
+            CHECK(s.info.horizontal);
+        }
+    }
+    CHECK(count(TOUCH_DRAG) > 1);
+    CHECK(dx == 30);
+    CHECK(last() && last()->event == TOUCH_DRAG_END && last()->info.vx == 0);
+    CHECK(count(TOUCH_TAP) == 0);
+}
+
+static void testFlick() {
+    // Fast but under SWIPE_MIN_DISTANCE: a flick with the release speed
+    seen.clear();
+    press(100, 150);
+    moveTo(140, 150, 40);
+    release();
+    CHECK(last() && last()->event == TOUCH_FLICK);
+    CHECK(last() && last()->info.vx >= TOUCH_FLICK_PX_S);
+}
+
+static void testSwipes() {
+    seen.clear();
+    press(40, 150);
+    moveTo(160, 150, 200);
+    release();
+    CHECK(last() && last()->event == TOUCH_SWIPE_RIGHT);
+
+    seen.clear();
+    press(200, 150);
+    moveTo(80, 150, 200);
+    release();
+    CHECK(last() && last()->event == TOUCH_SWIPE_LEFT);
+
+    // Vertical swipes only from their edge zones
+    seen.clear();
+    press(120, LCD_HEIGHT - 20);
+    moveTo(120, LCD_HEIGHT - 140, 150);
+    release();
+    CHECK(last() && last()->event == TOUCH_SWIPE_UP);
+
+    seen.clear();
+    press(120, 140);
+    moveTo(120, 20, 600);
+    hold(200);
+    release();
+    CHECK(last() && last()->event == TOUCH_DRAG_END && !last()->info.horizontal);
+}
+
+static void testHoldFilter() {
+    touchSetHoldFilter(onlySteppers);
+
+    // A held button repeats nothing and still taps on release
+    seen.clear();
+    press(60, 60);
+    hold(TOUCH_HOLD_MS + 100);
+    release();
+    CHECK(count(TOUCH_HOLD_REPEAT) == 0);
+    CHECK(count(TOUCH_TAP) == 1);
+
+    // A held stepper repeats from TOUCH_HOLD_MS on, and gives no tap
+    seen.clear();
+    press(160, 60);
+    hold(1000);
+    release();
+    int expected = 1 + (1000 - TOUCH_HOLD_MS) / TOUCH_REPEAT_MS;
+    CHECK(abs(count(TOUCH_HOLD_REPEAT) - expected) <= 1);
+    CHECK(count(TOUCH_TAP) == 0);
+
+    // Without a filter nothing repeats
+    touchSetHoldFilter(nullptr);
+    seen.clear();
+    press(160, 60);
+    hold(1000);
+    release();
+    CHECK(count(TOUCH_HOLD_REPEAT) == 0);
+    CHECK(count(TOUCH_TAP) == 1);
+
+    // Past LONG_PRESS_MS it is a long press instead of a tap
+    seen.clear();
+    press(60, 60);
+    hold(LONG_PRESS_MS + 100);
+    release();
+    CHECK(count(TOUCH_LONG_PRESS) == 1 && count(TOUCH_TAP) == 0);
+}
+
+static void testIdleReads() {
+    // No IRQ, no touch: the bus stays quiet
+    uint32_t reads = hostI2cReads;
+    hold(5000);
+    CHECK(hostI2cReads == reads);
+}
+
+// The gesture step is constant time: a sample late in a long touch costs
+// what an early one does. Timed on the host clock around each update.
+static void testBoundedCost() {
+    const int samples = 4000, window = 400;
+    std::vector<double> us;
+    us.reserve(samples);
+
+    TouchStats before;
+    touchGetStats(&before);
+    chip.set(true, 120, 140);
+    hostFireIrq(TOUCH_IRQ);
+    for (int i = 0; i < samples; i++) {
+        chip.set(true, 120 + (i % 80) - 40, 140 + (i % 50) - 25);
+        hostAdvanceMs(TICK_MS);
+        hostFireIrq(TOUCH_IRQ);
+        auto start = std::chrono::steady_clock::now();
+        int16_t x, y;
+        while (touchUpdate(x, y) != TOUCH_NONE) {}
+        us.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    chip.set(false, 120, 140);
+    hostFireIrq(TOUCH_IRQ);
+    hold(DEBOUNCE_MS + 50);
+    seen.clear();
+
+    TouchStats after;
+    touchGetStats(&after);
+    CHECK(after.gestureSteps - before.gestureSteps >= (uint32_t)samples);
+
+    // Medians, so a scheduler hiccup does not decide it
+    std::vector<double> early(us.begin() + 10, us.begin() + 10 + window);
+    std::vector<double> late(us.end() - window, us.end());
+    std::nth_element(early.begin(), early.begin() + window / 2, early.end());
+    std::nth_element(late.begin(), late.begin() + window / 2, late.end());
+    double earlyUs = early[window / 2], lateUs = late[window / 2];
+    printf("touch_test: gesture update median %.2f us early, %.2f us after %d samples\n",
+           earlyUs, lateUs, samples);
+    CHECK(lateUs < earlyUs * 3 + 2);
+}
+
+int main() {
+    hostI2cAttach(0x15, &chip);
+    chip.regs[0xA7] = 0xB6;   // CST816D
+
+    testInit();
+    testTap();
+    testDrag();
+    testFlick();
+    testSwipes();
+    testHoldFilter();
+    testIdleReads();
+    testBoundedCost();
+
+    if (failures) {
+        printf("touch_test: %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("touch_test: all passed\n");
+    return 0;
+}
@@ -14,6 +14,55 @@
 #define CST816_REG_YPOS_L    0x06
 #define CST816_REG_CHIP_ID   0xA7
 #define CST816_REG_FW_VER    0xA9
+#define CST816_REG_SLEEP_TIME 0xF9  // Idle seconds before auto-sleep
+#define CST816_REG_IRQ_CTL   0xFA
+#define CST816_REG_AUTO_SLEEP 0xFE  // Non-zero disables auto-sleep
+
+// IRQ_CTL bits: pulse periodically while touched, and when the state changes
+#define CST816_IRQ_EN_TOUCH  0x40
+#define CST816_IRQ_EN_CHANGE 0x20
+
+// Bytes on the wire for one touch read: address + register, address + 6 data
+#define TOUCH_READ_BUS_BYTES 9
+
+// Samples read from the controller, waiting for the gesture logic
+typedef struct {
+    bool touched;
+    int16_t x, y;
+    unsigned long ms;
+} TouchSample;
+
+// Events produced by the gesture logic, waiting for touchUpdate()
+typedef struct {
+    TouchEvent event;
+    TouchInfo info;
+} TouchQueued;
+
+// A point of the current touch's trajectory
+typedef struct {
+    int16_t x, y;
+    unsigned long ms;
+} TouchPoint;
+
+static TouchSample samples[TOUCH_SAMPLE_QUEUE_LEN];
+static uint8_t sampleHead = 0, sampleCount = 0;
+static TouchQueued events[TOUCH_EVENT_QUEUE_LEN];
+static uint8_t eventHead = 0, eventCount = 0;
+
+static bool configured = false;          // cst816Configure() reached the controller
+static volatile uint32_t irqCount = 0;   // Bumped by the IRQ line
+static uint32_t irqSeen = 0;
+static unsigned long lastReadMs = 0;
+
+static TouchStats stats;
+static unsigned long statsStartUs = 0;
+static TouchStats statsAtStart;
+
+// Trajectory ring of the current touch, oldest first
+static TouchPoint traj[TOUCH_TRAJ_LEN];
+static uint8_t trajHead = 0, trajCount = 0;
+
+static TouchInfo lastInfo;   // Of the event touchUpdate() returned last
 
 // Touch state tracking
 static bool lastTouchState = false;
@@ -23,6 +72,13 @@ static bool longPressHandled = false;
 static int16_t lastX = 0, lastY = 0;
 static int16_t touchStartX = 0;
 static int16_t touchStartY = 0;
+static bool dragging = false;        // Moved past TOUCH_DRAG_SLOP
+static bool dragHorizontal = false;  // Axis, fixed when the drag starts
+static int16_t dragX = 0, dragY = 0; // Position at the last drag event
+static TouchHoldFilter holdFilter = nullptr;
+static bool holdRepeats = false;     // This touch started where holding repeats
+static bool repeating = false;       // Hold-repeat has fired
+static unsigned long nextRepeatMs = 0;
 
 // Read a single byte from CST816
 static uint8_t cst816ReadReg(uint8_t reg) {
@@ -38,6 +94,25 @@ static uint8_t cst816ReadReg(uint8_t reg) {
     return 0;
 }
 
+static bool cst816WriteReg(uint8_t reg, uint8_t value) {
+    Wire.beginTransmission(CST816_I2C_ADDR);
+    Wire.write(reg);
+    Wire.write(value);
+    return Wire.endTransmission() == 0;
+}
+
+// Report through the IRQ line and let the controller doze when idle; a
+// touch wakes it, and nothing polls it while it sleeps
+static bool cst816Configure() {
+#if TOUCH_USE_IRQ
+    return cst816WriteReg(CST816_REG_IRQ_CTL, CST816_IRQ_EN_TOUCH | CST816_IRQ_EN_CHANGE) &&
+           cst816WriteReg(CST816_REG_SLEEP_TIME, TOUCH_AUTO_SLEEP_S) &&
+           cst816WriteReg(CST816_REG_AUTO_SLEEP, 0);
+#else
+    return true;
+#endif
+}
+
 // Read touch data (6 bytes starting at reg 0x01)
 static bool cst816ReadTouch(uint8_t &points, uint16_t &x, uint16_t &y) {
     Wire.beginTransmission(CST816_I2C_ADDR);
@@ -64,6 +139,11 @@ static bool cst816ReadTouch(uint8_t &points, uint16_t &x, uint16_t &y) {
     return true;
 }
 
+// The controller pulls TOUCH_IRQ low when it has a new report
+static void IRAM_ATTR touchIsr() {
+    irqCount = irqCount + 1;
+}
+
 bool touchInit() {
     // Configure interrupt pin
     pinMode(TOUCH_IRQ, INPUT_PULLUP);
@@ -71,13 +151,24 @@ bool touchInit() {
     // Small delay after I2C init
     delay(50);
     
-    // Check if CST816 is present
-    Wire.beginTransmission(CST816_I2C_ADDR);
-    uint8_t error = Wire.endTransmission();
-    
+    // Check if CST816 is present. It may still be starting up; the board
+    // has no reset line for it, so all we can do is wait and ask again.
+    uint8_t error = 0;
+    for (int i = 0; i < TOUCH_PROBE_TRIES; i++) {
+        if (i) delay(TOUCH_PROBE_RETRY_MS);
+        Wire.beginTransmission(CST816_I2C_ADDR);
+        error = Wire.endTransmission();
+        if (error == 0) break;
+    }
+
     if (error != 0) {
         Serial.printf("Touch init failed! I2C error: %d\n", error);
         Serial.println("CST816D not found at address 0x15");
+#if TOUCH_USE_IRQ
+        // Left dozing by the setup below before a warm reboot, it only
+        // answers again once touched
+        Serial.println("Touch: if it was asleep, touching the screen wakes it");
+#endif
         return false;
     }
     
@@ -86,69 +177,281 @@ bool touchInit() {
     uint8_t fwVer = cst816ReadReg(CST816_REG_FW_VER);
     
     Serial.printf("Touch initialized - CST816 ChipID: 0x%02X, FW: 0x%02X\n", chipId, fwVer);
+
+    // Should this miss (the controller dozed off between the probe and
+    // here), touchPoll() tries again after the next good read
+    configured = cst816Configure();
+#if TOUCH_USE_IRQ
+    attachInterrupt(digitalPinToInterrupt(TOUCH_IRQ), touchIsr, FALLING);
+#endif
+
+    statsStartUs = micros();
     return true;
 }
 
-TouchEvent touchUpdate(int16_t &x, int16_t &y) {
-    TouchEvent event = TOUCH_NONE;
+// Read the controller into the sample queue. With TOUCH_USE_IRQ only after
+// an IRQ, or when a touch has gone quiet for TOUCH_STALE_MS (a missed
+// release would otherwise leave it held for good).
+static void touchPoll(unsigned long now) {
+#if TOUCH_USE_IRQ
+    uint32_t irqs = irqCount;
+    bool pending = irqs != irqSeen;
+    stats.irqs += irqs - irqSeen;
+    irqSeen = irqs;
+    if (!pending && !(lastTouchState && now - lastReadMs >= TOUCH_STALE_MS)) return;
+    if (!pending) stats.staleReads++;
+#endif
+
     uint8_t points = 0;
     uint16_t touchX = 0, touchY = 0;
-    
+    unsigned long startUs = micros();
     bool readOk = cst816ReadTouch(points, touchX, touchY);
-    bool currentlyTouched = readOk && (points > 0);
-    unsigned long now = millis();
-    
+    stats.busUs += micros() - startUs;
+    stats.reads++;
+    stats.busBytes += TOUCH_READ_BUS_BYTES;
+    lastReadMs = now;
+    if (readOk && !configured) configured = cst816Configure();
+
+    if (sampleCount == TOUCH_SAMPLE_QUEUE_LEN) {
+        // Keep the newest; the oldest move is the least useful
+        sampleHead = (sampleHead + 1) % TOUCH_SAMPLE_QUEUE_LEN;
+        sampleCount--;
+        stats.samplesDropped++;
+    }
+    TouchSample &sm = samples[(sampleHead + sampleCount++) % TOUCH_SAMPLE_QUEUE_LEN];
+    sm.touched = readOk && points > 0;
+    sm.x = touchX;
+    sm.y = touchY;
+    sm.ms = now;
+}
+
+static void pushEvent(TouchEvent event, const TouchInfo &info) {
+    // A drag not taken yet absorbs the next one, so a slow reader gets
+    // fewer, longer drags instead of a full queue
+    if (event == TOUCH_DRAG && eventCount) {
+        TouchQueued &tail = events[(eventHead + eventCount - 1) % TOUCH_EVENT_QUEUE_LEN];
+        if (tail.event == TOUCH_DRAG) {
+            int16_t dx = tail.info.dx + info.dx;
+            int16_t dy = tail.info.dy + info.dy;
+            tail.info = info;
+            tail.info.dx = dx;
+            tail.info.dy = dy;
+            return;
+        }
+    }
+    if (eventCount == TOUCH_EVENT_QUEUE_LEN) {
+        stats.eventsDropped++;
+        return;
+    }
+    events[(eventHead + eventCount++) % TOUCH_EVENT_QUEUE_LEN] = {event, info};
+}
+
+static void trajPush(int16_t x, int16_t y, unsigned long ms) {
+    if (trajCount == TOUCH_TRAJ_LEN) {
+        trajHead = (trajHead + 1) % TOUCH_TRAJ_LEN;
+        trajCount--;
+    }
+    traj[(trajHead + trajCount++) % TOUCH_TRAJ_LEN] = {x, y, ms};
+}
+
+// Velocity in px/s over the last TOUCH_VELOCITY_MS of the trajectory, seen
+// at time now (zero if the finger has been still since). Looks at no more
+// than TOUCH_TRAJ_LEN points.
+static void trajVelocity(unsigned long now, int16_t &vx, int16_t &vy) {
+    vx = vy = 0;
+    if (trajCount < 2) return;
+
+    const TouchPoint &last = traj[(trajHead + trajCount - 1) % TOUCH_TRAJ_LEN];
+    if (now - last.ms > TOUCH_VELOCITY_MS) return;
+
+    // Back to the first point at least a window older than the last one
+    const TouchPoint *first = &last;
+    for (uint8_t i = trajCount - 1; i-- > 0;) {
+        first = &traj[(trajHead + i) % TOUCH_TRAJ_LEN];
+        if (last.ms - first->ms >= TOUCH_VELOCITY_MS) break;
+    }
+    long dt = last.ms - first->ms;
+    if (dt <= 0) return;
+    vx = constrain((long)(last.x - first->x) * 1000 / dt, -32767L, 32767L);
+    vy = constrain((long)(last.y - first->y) * 1000 / dt, -32767L, 32767L);
+}
+
+static TouchInfo makeInfo(int16_t x, int16_t y) {
+    TouchInfo info = {};
+    info.x = x;
+    info.y = y;
+    info.startX = touchStartX;
+    info.startY = touchStartY;
+    info.horizontal = dragHorizontal;
+    return info;
+}
+
+// A release after a drag: the vertical zone swipes first (they change
+// screens), then horizontal swipes, flicks, and a plain end of drag
+static TouchEvent classifyRelease(const TouchInfo &info) {
+    int16_t deltaY = touchStartY - lastY;  // Positive = swipe up, Negative = swipe down
+    int16_t deltaX = lastX - touchStartX;
+    bool startedAtBottom = touchStartY > (LCD_HEIGHT - SWIPE_BOTTOM_ZONE);
+    bool startedAtTop = touchStartY < SWIPE_TOP_ZONE;
+
+    if (!dragHorizontal && startedAtBottom && deltaY > SWIPE_MIN_DISTANCE) return TOUCH_SWIPE_UP;
+    if (!dragHorizontal && startedAtTop && deltaY < -SWIPE_MIN_DISTANCE) return TOUCH_SWIPE_DOWN;
+    if (dragHorizontal && abs(deltaX) > SWIPE_MIN_DISTANCE) {
+        return deltaX > 0 ? TOUCH_SWIPE_RIGHT : TOUCH_SWIPE_LEFT;
+    }
+    if ((long)info.vx * info.vx + (long)info.vy * info.vy >= (long)TOUCH_FLICK_PX_S * TOUCH_FLICK_PX_S) {
+        return TOUCH_FLICK;
+    }
+    return TOUCH_DRAG_END;
+}
+
+static void logStats() {
+#if TOUCH_STATS_LOG_MS > 0
+    unsigned long elapsed = micros() - statsStartUs;
+    if (elapsed < TOUCH_STATS_LOG_MS * 1000UL) return;
+
+    uint32_t reads = stats.reads - statsAtStart.reads;
+    uint32_t busUs = stats.busUs - statsAtStart.busUs;
+    Serial.printf("Touch: %lu reads (%lu IRQs, %lu stale) in %lu ms, I2C busy %lu us (%lu.%02lu%%), "
+                  "gesture step max %lu us\n",
+                  (unsigned long)reads, (unsigned long)(stats.irqs - statsAtStart.irqs),
+                  (unsigned long)(stats.staleReads - statsAtStart.staleReads),
+                  elapsed / 1000, (unsigned long)busUs,
+                  (unsigned long)((uint64_t)busUs * 100 / elapsed),
+                  (unsigned long)((uint64_t)busUs * 10000 / elapsed % 100),
+                  (unsigned long)stats.gestureMaxUs);
+    statsAtStart = stats;
+    statsStartUs = micros();
+#endif
+}
+
+void touchGetStats(TouchStats *out) {
+    *out = stats;
+}
+
+// Gesture logic: one sample in, at most one event out. Constant time
+// apart from the velocity, which is bounded by TOUCH_TRAJ_LEN.
+static void touchGesture(const TouchSample &sm) {
+    bool currentlyTouched = sm.touched;
+    unsigned long now = sm.ms;
+
     if (currentlyTouched) {
-        lastX = touchX;
-        lastY = touchY;
-        x = touchX;
-        y = touchY;
-        
         if (!lastTouchState) {
             // Touch just started - record start position
             touchStartTime = now;
-            touchStartX = touchX;
-            touchStartY = touchY;
+            touchStartX = sm.x;
+            touchStartY = sm.y;
             longPressHandled = false;
-        } else if (!longPressHandled && (now - touchStartTime > LONG_PRESS_MS)) {
-            // Long press threshold reached
-            longPressHandled = true;
-            event = TOUCH_LONG_PRESS;
+            dragging = false;
+            holdRepeats = holdFilter && holdFilter(sm.x, sm.y);
+            repeating = false;
+            nextRepeatMs = now + TOUCH_HOLD_MS;
+            trajCount = 0;
+        }
+        lastX = sm.x;
+        lastY = sm.y;
+        trajPush(sm.x, sm.y, now);
+
+        // Moving off the start point makes it a drag, unless it is already
+        // repeating (a finger rolling on a held stepper is not a drag)
+        int16_t moveX = sm.x - touchStartX, moveY = sm.y - touchStartY;
+        if (!dragging && !repeating && (abs(moveX) > TOUCH_DRAG_SLOP || abs(moveY) > TOUCH_DRAG_SLOP)) {
+            dragging = true;
+            dragHorizontal = abs(moveX) >= abs(moveY);
+            dragX = touchStartX;
+            dragY = touchStartY;
         }
-    } else {
-        // Touch released or not touching
-        if (lastTouchState && !longPressHandled) {
-            int16_t deltaY = touchStartY - lastY;  // Positive = swipe up, Negative = swipe down
-            bool startedAtBottom = touchStartY > (LCD_HEIGHT - SWIPE_BOTTOM_ZONE);
-            bool startedAtTop = touchStartY < SWIPE_TOP_ZONE;
-            
-            if (startedAtBottom && deltaY > SWIPE_MIN_DISTANCE) {
-                // Swipe up detected
-                event = TOUCH_SWIPE_UP;
-            } else if (startedAtTop && deltaY < -SWIPE_MIN_DISTANCE) {
-                // Swipe down detected
-                event = TOUCH_SWIPE_DOWN;
-            } else if (now - lastButtonPress > DEBOUNCE_MS) {
-                // Short tap
-                lastButtonPress = now;
-                x = lastX;
-                y = lastY;
-                event = TOUCH_TAP;
-            }
+        if (dragging && (sm.x != dragX || sm.y != dragY)) {
+            TouchInfo info = makeInfo(sm.x, sm.y);
+            info.dx = sm.x - dragX;
+            info.dy = sm.y - dragY;
+            trajVelocity(now, info.vx, info.vy);
+            dragX = sm.x;
+            dragY = sm.y;
+            pushEvent(TOUCH_DRAG, info);
         }
+    } else if (lastTouchState) {
+        // Touch released
+        TouchInfo info = makeInfo(lastX, lastY);
+        if (dragging) {
+            trajVelocity(now, info.vx, info.vy);
+            pushEvent(classifyRelease(info), info);
+        } else if (!longPressHandled && !repeating && now - lastButtonPress > DEBOUNCE_MS) {
+            // Short tap
+            lastButtonPress = now;
+            pushEvent(TOUCH_TAP, info);
+        }
+        trajCount = 0;
     }
-    
+
     lastTouchState = currentlyTouched;
-    return event;
 }
 
-bool touchInButton(int16_t x, int16_t y) {
-    return (x >= BTN_X && x <= (BTN_X + BTN_WIDTH) &&
-            y >= BTN_Y && y <= (BTN_Y + BTN_HEIGHT));
+TouchEvent touchUpdate(int16_t &x, int16_t &y) {
+    unsigned long now = millis();
+    touchPoll(now);
+
+    while (sampleCount) {
+        unsigned long startUs = micros();
+        touchGesture(samples[sampleHead]);
+        uint32_t us = micros() - startUs;
+        if (us > stats.gestureMaxUs) stats.gestureMaxUs = us;
+        stats.gestureSteps++;
+        sampleHead = (sampleHead + 1) % TOUCH_SAMPLE_QUEUE_LEN;
+        sampleCount--;
+    }
+
+    // Holding needs no new reports, only time
+    if (lastTouchState && !dragging) {
+        if (holdRepeats && (long)(now - nextRepeatMs) >= 0) {
+            repeating = true;
+            nextRepeatMs = now + TOUCH_REPEAT_MS;
+            pushEvent(TOUCH_HOLD_REPEAT, makeInfo(lastX, lastY));
+        }
+        if (!longPressHandled && now - touchStartTime > LONG_PRESS_MS) {
+            longPressHandled = true;
+            pushEvent(TOUCH_LONG_PRESS, makeInfo(lastX, lastY));
+        }
+    }
+
+    logStats();
+
+    if (!eventCount) {
+        // Coordinates follow the finger while it is down
+        if (lastTouchState) {
+            x = lastX;
+            y = lastY;
+        }
+        return TOUCH_NONE;
+    }
+    TouchQueued &ev = events[eventHead];
+    eventHead = (eventHead + 1) % TOUCH_EVENT_QUEUE_LEN;
+    eventCount--;
+    lastInfo = ev.info;
+    x = ev.info.x;
+    y = ev.info.y;
+    return ev.event;
+}
+
+void touchGetInfo(TouchInfo *info) {
+    *info = lastInfo;
+}
+
+void touchSetHoldFilter(TouchHoldFilter filter) {
+    holdFilter = filter;
 }
 
 void touchReset() {
     lastTouchState = true;  // Prevent immediate re-trigger after wake
     longPressHandled = false;
     touchStartTime = 0;
+    dragging = false;
+    holdRepeats = false;
+    repeating = false;
+    nextRepeatMs = millis() + TOUCH_HOLD_MS;
+    trajCount = 0;
+    sampleCount = 0;
+    eventCount = 0;
+    irqSeen = irqCount;
+    lastReadMs = millis();
 }
@@ -8,11 +8,46 @@
 enum TouchEvent {
     TOUCH_NONE,
     TOUCH_TAP,
-    TOUCH_SWIPE_UP,
+    TOUCH_SWIPE_UP,      // Vertical swipes start in the bottom/top zone
     TOUCH_SWIPE_DOWN,
-    TOUCH_LONG_PRESS
+    TOUCH_LONG_PRESS,
+    TOUCH_DRAG,          // Finger moved; dx/dy since the previous drag event
+    TOUCH_DRAG_END,      // Released after a drag that is none of the below
+    TOUCH_FLICK,         // Released while moving faster than TOUCH_FLICK_PX_S
+    TOUCH_SWIPE_LEFT,    // Released after a horizontal drag of SWIPE_MIN_DISTANCE
+    TOUCH_SWIPE_RIGHT,
+    TOUCH_HOLD_REPEAT    // Held still where the hold filter allows it: after
+                         // TOUCH_HOLD_MS, then every TOUCH_REPEAT_MS
 };
 
+// Asked once per touch, at its start point: may holding there repeat?
+// A touch that repeats gives no tap on release.
+typedef bool (*TouchHoldFilter)(int16_t x, int16_t y);
+
+// Details of an event. Gestures come from the touch's trajectory (the
+// last TOUCH_TRAJ_LEN reads); a touch that moves past TOUCH_DRAG_SLOP
+// becomes a drag, and its axis is fixed at that point.
+typedef struct {
+    int16_t x, y;            // Where it happened (last point for releases)
+    int16_t startX, startY;  // Where the touch began
+    int16_t dx, dy;          // TOUCH_DRAG: movement since the previous drag event
+    int16_t vx, vy;          // Velocity in px/s (drags and releases after a drag)
+    bool horizontal;         // Drag axis
+} TouchInfo;
+
+// I2C cost of touch input (see TOUCH_USE_IRQ)
+typedef struct {
+    uint32_t irqs;            // IRQ pulses from the controller
+    uint32_t reads;           // Touch reads (I2C transactions)
+    uint32_t staleReads;      // Reads to confirm a touch with no recent IRQ
+    uint32_t busBytes;        // Bytes on the bus for those reads
+    uint32_t busUs;           // Time spent in them
+    uint32_t samplesDropped;  // Reads lost to a full sample queue
+    uint32_t eventsDropped;   // Events lost to a full event queue
+    uint32_t gestureSteps;    // Samples run through the gesture logic
+    uint32_t gestureMaxUs;    // Longest of them
+} TouchStats;
+
 // Initialize touch controller (CST816D at I2C address 0x15)
 bool touchInit();
 
@@ -20,10 +55,15 @@ bool touchInit();
 // If event occurred, x and y are populated with coordinates
 TouchEvent touchUpdate(int16_t &x, int16_t &y);
 
-// Check if coordinates are within the button area
-bool touchInButton(int16_t x, int16_t y);
+// Details of the event touchUpdate() returned last
+void touchGetInfo(TouchInfo* info);
+
+// Where TOUCH_HOLD_REPEAT may fire. Without a filter it never does.
+void touchSetHoldFilter(TouchHoldFilter filter);
 
 // Reset touch state (call after wake from sleep)
 void touchReset();
 
+void touchGetStats(TouchStats* stats);
+
 #endif // TOUCH_H
@@ -0,0 +1,400 @@
+#include "ui.h"
+#include "display.h"
+#include "config.h"
+
+// Slider layout (inside the widget)
+#define SLIDER_BAR_HEIGHT  16
+#define SLIDER_BAR_Y_OFF   22
+
+// Stepper value area, centered between the label and the + mark
+#define STEPPER_VALUE_W  60
+
+static UiWidget pool[UI_MAX_WIDGETS];
+static uint8_t poolUsed = 0;
+
+static UiWidget* active = nullptr;
+static UiStats stats;
+
+// ============================================================================
+// Building
+// ============================================================================
+
+UiWidget* uiCreate(UiWidget* parent, UiType type, int16_t x, int16_t y, int16_t w, int16_t h) {
+    if (poolUsed >= UI_MAX_WIDGETS) {
+        Serial.println("UI: widget pool exhausted");
+        return nullptr;
+    }
+
+    UiWidget* wd = &pool[poolUsed++];
+    memset(wd, 0, sizeof(*wd));
+    wd->type = type;
+    wd->rx = x;
+    wd->ry = y;
+    wd->rw = w;
+    wd->rh = h;
+    wd->textSize = 1;
+    wd->textColor = COLOR_WHITE;
+    wd->color = COLOR_DARKGRAY;
+    wd->dirty = UI_DIRTY_FULL;
+
+    if (parent) {
+        wd->parent = parent;
+        UiWidget** link = &parent->child;
+        while (*link) link = &(*link)->next;
+        *link = wd;
+    }
+    return wd;
+}
+
+void uiSetText(UiWidget* w, const char* text, uint8_t size, uint16_t color) {
+    w->text = text;
+    w->textSize = size;
+    w->textColor = color;
+}
+
+void uiSetRange(UiWidget* w, int16_t minVal, int16_t maxVal, int16_t step, int16_t value) {
+    w->minVal = minVal;
+    w->maxVal = maxVal;
+    w->step = step;
+    w->value = minVal - 1;   // Force the update below
+    uiSetValue(w, value);
+}
+
+// ============================================================================
+// Layout
+// ============================================================================
+
+static void layoutChildren(UiWidget* w) {
+    int16_t ix = w->x + w->pad;
+    int16_t iy = w->y + w->pad;
+    int16_t iw = w->w - 2 * w->pad;
+    int16_t ih = w->h - 2 * w->pad;
+
+    int n = 0;
+    for (UiWidget* c = w->child; c; c = c->next) n++;
+    int16_t share = n ? (iw - w->gap * (n - 1)) / n : 0;
+
+    int16_t cx = ix, cy = iy;
+    for (UiWidget* c = w->child; c; c = c->next) {
+        switch (w->layout) {
+            case UI_LAYOUT_COLUMN:
+                c->x = ix;
+                c->y = cy;
+                c->w = iw;
+                c->h = c->rh;
+                cy += c->h + w->gap;
+                break;
+            case UI_LAYOUT_ROW:
+                c->x = cx;
+                c->y = iy;
+                c->w = c->rw ? c->rw : share;
+                c->h = c->rh ? c->rh : ih;
+                cx += c->w + w->gap;
+                break;
+            default:
+                c->x = ix + c->rx;
+                c->y = iy + c->ry;
+                c->w = c->rw ? c->rw : iw - c->rx;
+                c->h = c->rh ? c->rh : ih - c->ry;
+                break;
+        }
+        layoutChildren(c);
+    }
+}
+
+// ============================================================================
+// Screens and changes
+// ============================================================================
+
+void uiShow(UiWidget* root) {
+    active = root;
+    if (!root) return;
+
+    root->x = root->rx;
+    root->y = root->ry;
+    root->w = root->rw ? root->rw : LCD_WIDTH;
+    root->h = root->rh ? root->rh : LCD_HEIGHT;
+    layoutChildren(root);
+    root->dirty = UI_DIRTY_FULL;
+}
+
+UiWidget* uiActive() {
+    return active;
+}
+
+void uiInvalidate(UiWidget* w, uint8_t dirty) {
+    if (w) w->dirty |= dirty;
+}
+
+void uiSetValue(UiWidget* w, int16_t value) {
+    value = constrain(value, w->minVal, w->maxVal);
+    if (value == w->value) return;
+    w->value = value;
+    w->dirty |= UI_DIRTY_VALUE;
+}
+
+void uiSetHidden(UiWidget* w, bool hidden) {
+    if (hidden == ((w->flags & UI_F_HIDDEN) != 0)) return;
+    if (hidden) w->flags |= UI_F_HIDDEN;
+    else w->flags &= ~UI_F_HIDDEN;
+    // A hidden widget that is still dirty gets erased by the renderer
+    w->dirty = UI_DIRTY_FULL;
+}
+
+// ============================================================================
+// Painting
+// ============================================================================
+
+static void printCentered(Arduino_GFX* gfx, const UiWidget* w, const char* text, int16_t cy) {
+    int16_t tw = strlen(text) * 6 * w->textSize;
+    gfx->setCursor(w->x + (w->w - tw) / 2, cy);
+    gfx->print(text);
+}
+
+static void paintSliderValue(Arduino_GFX* gfx, UiWidget* w) {
+    int16_t barX = w->x + 6;
+    int16_t barY = w->y + SLIDER_BAR_Y_OFF;
+    int16_t barW = w->w - 12;
+
+    gfx->fillRect(barX, barY, barW, SLIDER_BAR_HEIGHT, COLOR_BLACK);
+    int16_t fillW = map(w->value, w->minVal, w->maxVal, 0, barW);
+    if (fillW > 0) gfx->fillRect(barX, barY, fillW, SLIDER_BAR_HEIGHT, w->color);
+
+    // Left/right tap indicators
+    gfx->setTextSize(2);
+    gfx->setTextColor(COLOR_WHITE);
+    gfx->setCursor(barX + 4, barY + 1);
+    gfx->print("-");
+    gfx->setCursor(barX + barW - 16, barY + 1);
+    gfx->print("+");
+
+    // Percentage (top right)
+    char buf[8];
+    snprintf(buf, sizeof(buf), "%3d%%", (int)map(w->value, w->minVal, w->maxVal, 0, 100));
+    gfx->fillRect(w->x + w->w - 36, w->y + 4, 32, 12, COLOR_DARKGRAY);
+    gfx->setTextSize(1);
+    gfx->setTextColor(w->color);
+    gfx->setCursor(w->x + w->w - 32, w->y + 6);
+    gfx->print(buf);
+}
+
+static void paintStepperValue(Arduino_GFX* gfx, UiWidget* w) {
+    char buf[12];
+    snprintf(buf, sizeof(buf), w->format ? w->format : "%d", w->value);
+
+    gfx->fillRect(w->x + (w->w - STEPPER_VALUE_W) / 2, w->y + 8, STEPPER_VALUE_W, 16, COLOR_DARKGRAY);
+    gfx->setTextSize(2);
+    gfx->setTextColor(COLOR_WHITE);
+    printCentered(gfx, w, buf, w->y + 8);
+}
+
+static void paint(UiWidget* w, uint8_t dirty) {
+    Arduino_GFX* gfx = displayGetGFX();
+    bool full = dirty & UI_DIRTY_FULL;
+
+    switch (w->type) {
+        case UI_PANEL:
+        case UI_BUTTON:
+            if (w->radius) gfx->fillRoundRect(w->x, w->y, w->w, w->h, w->radius, w->color);
+            else gfx->fillRect(w->x, w->y, w->w, w->h, w->color);
+            if (w->flags & UI_F_BORDER) {
+                gfx->drawRoundRect(w->x, w->y, w->w, w->h, w->radius, COLOR_LIGHTGRAY);
+            }
+            if (w->type == UI_BUTTON && w->text) {
+                gfx->setTextSize(w->textSize);
+                gfx->setTextColor(w->textColor);
+                printCentered(gfx, w, w->text, w->y + (w->h - 8 * w->textSize) / 2);
+            }
+            break;
+
+        case UI_LABEL:
+            if (w->parent) gfx->fillRect(w->x, w->y, w->w, w->h, w->parent->color);
+            gfx->setTextSize(w->textSize);
+            gfx->setTextColor(w->textColor);
+            gfx->setCursor(w->x, w->y);
+            gfx->print(w->text);
+            break;
+
+        case UI_SLIDER:
+            if (full) {
+                gfx->fillRoundRect(w->x, w->y, w->w, w->h, 4, COLOR_DARKGRAY);
+                gfx->setTextSize(1);
+                gfx->setTextColor(COLOR_WHITE);
+                gfx->setCursor(w->x + 6, w->y + 6);
+                gfx->print(w->text);
+            }
+            paintSliderValue(gfx, w);
+            break;
+
+        case UI_STEPPER:
+            if (full) {
+                gfx->fillRoundRect(w->x, w->y, w->w, w->h, 4, COLOR_DARKGRAY);
+                gfx->setTextSize(2);
+                gfx->setTextColor(COLOR_LIGHTGRAY);
+                gfx->setCursor(w->x + 8, w->y + 8);
+                gfx->print("-");
+                gfx->setCursor(w->x + w->w - 20, w->y + 8);
+                gfx->print("+");
+                gfx->setTextSize(1);
+                gfx->setCursor(w->x + 26, w->y + 12);
+                gfx->print(w->text);
+            }
+            paintStepperValue(gfx, w);
+            break;
+
+        case UI_CUSTOM:
+            if (w->draw) w->draw(w, dirty);
+            break;
+    }
+}
+
+// Fill a hidden widget's area with the parent's color and repaint the
+// siblings it overlapped
+static void erase(UiWidget* w) {
+    Arduino_GFX* gfx = displayGetGFX();
+    if (!w->parent) return;
+
+    gfx->fillRect(w->x, w->y, w->w, w->h, w->parent->color);
+    for (UiWidget* s = w->parent->child; s; s = s->next) {
+        if (s == w || (s->flags & UI_F_HIDDEN)) continue;
+        if (s->x < w->x + w->w && w->x < s->x + s->w && s->y < w->y + w->h && w->y < s->y + s->h) {
+            s->dirty |= UI_DIRTY_FULL;
+        }
+    }
+}
+
+// The parent's fill covered its children; hidden ones need no erasing
+static void markChildren(UiWidget* w) {
+    for (UiWidget* c = w->child; c; c = c->next) {
+        c->dirty = (c->flags & UI_F_HIDDEN) ? 0 : UI_DIRTY_FULL;
+    }
+}
+
+// Pre-order walk of the active screen; hidden subtrees are skipped
+static UiWidget* nextWidget(UiWidget* w) {
+    if (w->child && !(w->flags & UI_F_HIDDEN)) return w->child;
+    while (w && w != active) {
+        if (w->next) return w->next;
+        w = w->parent;
+    }
+    return nullptr;
+}
+
+bool uiRender(uint32_t budgetUs) {
+    if (!active) return true;
+
+    unsigned long startUs = micros();
+    uint32_t painted = 0;
+    bool left = false;
+
+    for (UiWidget* w = active; w; w = nextWidget(w)) {
+        if (!w->dirty) continue;
+        if (painted > 0 && micros() - startUs >= budgetUs) {
+            left = true;
+            break;
+        }
+
+        uint8_t dirty = w->dirty;
+        w->dirty = 0;
+        if (w->flags & UI_F_HIDDEN) {
+            erase(w);
+        } else {
+            paint(w, dirty);
+            if (dirty & UI_DIRTY_FULL) markChildren(w);
+        }
+        painted++;
+    }
+
+    if (painted) {
+        uint32_t us = micros() - startUs;
+        stats.frames++;
+        stats.painted += painted;
+        stats.lastUs = us;
+        if (us > stats.maxUs) stats.maxUs = us;
+        if (left) stats.deferred++;
+    }
+    return !left;
+}
+
+// ============================================================================
+// Input
+// ============================================================================
+
+static bool takesTaps(const UiWidget* w) {
+    return w->onTap || w->type == UI_SLIDER || w->type == UI_STEPPER;
+}
+
+static bool contains(const UiWidget* w, int16_t x, int16_t y, int16_t slop) {
+    return x >= w->x - slop && x < w->x + w->w + slop &&
+           y >= w->y - slop && y < w->y + w->h + slop;
+}
+
+static UiWidget* hitIn(UiWidget* w, int16_t x, int16_t y) {
+    if (w->flags & UI_F_HIDDEN) return nullptr;
+    // Children lie inside their parent, so the whole subtree can be skipped
+    if (!contains(w, x, y, UI_HIT_SLOP_MAX)) return nullptr;
+
+    // Later siblings are drawn on top
+    UiWidget* found = nullptr;
+    for (UiWidget* c = w->child; c; c = c->next) {
+        UiWidget* h = hitIn(c, x, y);
+        if (h) found = h;
+    }
+    if (found) return found;
+
+    return (takesTaps(w) && contains(w, x, y, w->hitSlop)) ? w : nullptr;
+}
+
+UiWidget* uiHitTest(int16_t x, int16_t y) {
+    return active ? hitIn(active, x, y) : nullptr;
+}
+
+static bool changeValue(UiWidget* w, int16_t value) {
+    int16_t before = w->value;
+    uiSetValue(w, value);
+    if (w->value != before && w->onChange) w->onChange(w);
+    return w->value != before;
+}
+
+// Left half decreases, right half increases
+static bool stepValue(UiWidget* w, int16_t x) {
+    return changeValue(w, w->value + (x < w->x + w->w / 2 ? -w->step : w->step));
+}
+
+bool uiTap(int16_t x, int16_t y) {
+    UiWidget* w = uiHitTest(x, y);
+    if (!w) return false;
+
+    if (w->type == UI_SLIDER || w->type == UI_STEPPER) return stepValue(w, x);
+
+    w->onTap(w);
+    return true;
+}
+
+static bool repeatable(const UiWidget* w) {
+    return w && (w->type == UI_SLIDER || w->type == UI_STEPPER);
+}
+
+bool uiRepeat(int16_t x, int16_t y) {
+    UiWidget* w = uiHitTest(x, y);
+    if (!repeatable(w)) return false;
+    return stepValue(w, x);
+}
+
+bool uiCanRepeat(int16_t x, int16_t y) {
+    return repeatable(uiHitTest(x, y));
+}
+
+bool uiDrag(int16_t x0, int16_t y0, int16_t x) {
+    UiWidget* w = uiHitTest(x0, y0);
+    if (!w || w->type != UI_SLIDER) return false;
+
+    // Same bar geometry as paintSliderValue(); no step snapping while dragging
+    int16_t barX = w->x + 6;
+    int16_t barW = w->w - 12;
+    return changeValue(w, map(constrain(x - barX, 0, barW), 0, barW, w->minVal, w->maxVal));
+}
+
+void uiGetStats(UiStats* out) {
+    *out = stats;
+}
@@ -0,0 +1,129 @@
+#ifndef UI_H
+#define UI_H
+
+#include <Arduino.h>
+
+// Retained-mode widgets.
+// Screens are trees of widgets built once at startup. Changing a widget
+// only marks it dirty; uiRender() repaints dirty widgets in tree order
+// (parents before children) until the frame budget runs out and leaves the
+// rest for the next call. Taps, drags and hold-repeats are routed to the
+// topmost widget under the point.
+
+typedef enum {
+    UI_PANEL,     // Filled (rounded) rectangle, optional border
+    UI_LABEL,     // Text on the parent's color
+    UI_BUTTON,    // Panel with centered text
+    UI_SLIDER,    // Label, percentage and a bar; left half -, right half +, or drag
+    UI_STEPPER,   // Label and a formatted value; left half -, right half +
+    UI_CUSTOM     // Drawn by the owner's draw callback
+} UiType;
+
+typedef enum {
+    UI_LAYOUT_NONE,    // Children keep their own position (relative to the parent)
+    UI_LAYOUT_COLUMN,  // Stacked top to bottom, full width, own height
+    UI_LAYOUT_ROW      // Side by side, equal widths, full height
+} UiLayout;
+
+// Dirty flags
+#define UI_DIRTY_FULL   0x01   // Everything, children included
+#define UI_DIRTY_VALUE  0x02   // Only the value part (sliders, steppers)
+
+// Widget flags
+#define UI_F_BORDER     0x01
+#define UI_F_HIDDEN     0x02
+
+typedef struct UiWidget UiWidget;
+typedef void (*UiDrawFn)(UiWidget* w, uint8_t dirty);
+typedef void (*UiEventFn)(UiWidget* w);
+
+struct UiWidget {
+    UiType type;
+    uint8_t flags;
+    uint8_t dirty;
+
+    // Requested geometry relative to the parent (w/h of 0 = fill), and the
+    // absolute rectangle computed by layout
+    int16_t rx, ry, rw, rh;
+    int16_t x, y, w, h;
+
+    // Containers
+    UiLayout layout;
+    int8_t pad;              // Inset on all sides
+    int8_t gap;              // Between children
+    int8_t hitSlop;          // Extra touch margin around the widget
+
+    UiWidget* parent;
+    UiWidget* child;         // First child
+    UiWidget* next;          // Next sibling
+
+    // Appearance
+    const char* text;
+    uint16_t color;          // Fill (panels, buttons), accent (sliders)
+    uint16_t textColor;
+    uint8_t textSize;
+    uint8_t radius;
+
+    // Sliders and steppers
+    int16_t value, minVal, maxVal, step;
+    const char* format;      // printf format for the stepper value
+
+    UiDrawFn draw;           // UI_CUSTOM
+    UiEventFn onTap;         // Buttons, or any widget that wants taps
+    UiEventFn onChange;      // Sliders and steppers, after the value changed
+    void* user;
+};
+
+typedef struct {
+    uint32_t frames;         // uiRender() calls that painted something
+    uint32_t painted;        // Widgets painted
+    uint32_t deferred;       // Frames that ran out of budget with work left
+    uint32_t lastUs;
+    uint32_t maxUs;
+} UiStats;
+
+// ---- Building ----
+
+// New widget appended to parent's children (parent null for a screen root)
+UiWidget* uiCreate(UiWidget* parent, UiType type, int16_t x, int16_t y, int16_t w, int16_t h);
+void uiSetText(UiWidget* w, const char* text, uint8_t size, uint16_t color);
+void uiSetRange(UiWidget* w, int16_t minVal, int16_t maxVal, int16_t step, int16_t value);
+
+// ---- Screens ----
+
+// Make root the visible screen (null for none), lay it out and mark it all dirty
+void uiShow(UiWidget* root);
+UiWidget* uiActive();
+
+// ---- Changes ----
+
+void uiInvalidate(UiWidget* w, uint8_t dirty);
+void uiSetValue(UiWidget* w, int16_t value);
+void uiSetHidden(UiWidget* w, bool hidden);
+
+// ---- Rendering and input ----
+
+// Paint dirty widgets for up to budgetUs (at least one widget per call).
+// Returns true when nothing is left to paint.
+bool uiRender(uint32_t budgetUs);
+
+// Route a tap to the widget under (x, y). Returns true if one took it.
+bool uiTap(int16_t x, int16_t y);
+
+// Press-and-hold: step the slider or stepper under (x, y) again, as a tap
+// would. Buttons ignore it. Returns true if the value changed.
+bool uiRepeat(int16_t x, int16_t y);
+
+// Whether uiRepeat() has anything to step at (x, y)
+bool uiCanRepeat(int16_t x, int16_t y);
+
+// Drag of a touch that began at (x0, y0): a slider there takes the value
+// under x. Returns true if the value changed.
+bool uiDrag(int16_t x0, int16_t y0, int16_t x);
+
+// Topmost visible widget under (x, y) on the active screen, or null
+UiWidget* uiHitTest(int16_t x, int16_t y);
+
+void uiGetStats(UiStats* stats);
+
+#endif // UI_H
@@ -6,6 +6,7 @@
 #include "sound.h"
 #include "storage.h"
 #include "rtc.h"
+#include "telemetry.h"
 
 // ============================================================================
 // Sensitivity storage and names
@@ -85,6 +86,15 @@ static int reps = 0;
 // Peak velocity tracking
 static float peakVelocity = 0.0f;
 
+// Current rep, for the live rep summary
+static uint32_t repStartMs = 0;
+static float repPeak = 0.0f;
+static float repSum = 0.0f;
+static uint16_t repSamples = 0;
+
+// Summaries of the last REP_TABLE_SIZE reps
+static RepSummary repTable[REP_TABLE_SIZE];
+
 // ZUPT state
 static uint32_t lowVelocityStartMs = 0;
 static bool inLowVelocityState = false;
@@ -180,6 +190,11 @@ static void startSet(uint32_t nowMs) {
   
   lastDefinitiveDirection = 0;
   lastRepCountedMs = 0;
+
+  repStartMs = nowMs;
+  repPeak = 0.0f;
+  repSum = 0.0f;
+  repSamples = 0;
   
   inLowVelocityState = false;
   wasMoving = false;
@@ -214,6 +229,8 @@ static void updateDisplay(bool force) {
     displayUpdatePeakVelocity(peakVelocity);
     lastDisplayedPeakVel = peakVelocity;
   }
+
+  displayUpdateChart();
 }
 
 // ============================================================================
@@ -251,7 +268,9 @@ void workoutReset() {
   displayUpdateReps(0);
   displayUpdateTime(0);
   displayUpdatePeakVelocity(0.0f);
+  displayResetChart();
 
+  telemetryReset();
   imuZeroVelocity();
 }
 
@@ -282,6 +301,9 @@ void workoutProcessVelocity(float v) {
   if (dtMs > 100) dtMs = 100;
   lastSampleMs = now;
 
+  telemetryPushSample(v, now);
+  displayChartAddSample(v, now);
+
   float vAbs = fabsf(v);
   
   // Get current thresholds
@@ -312,6 +334,11 @@ void workoutProcessVelocity(float v) {
   if (vAbs > peakVelocity) {
     peakVelocity = vAbs;
   }
+  if (vAbs > repPeak) {
+    repPeak = vAbs;
+  }
+  repSum += vAbs;
+  repSamples++;
 
   // -------------------------------------------------------------------------
   // Rep counting: Direction reversal detection
@@ -332,6 +359,24 @@ void workoutProcessVelocity(float v) {
       if (enoughTimePassed && hasGyroActivity) {
         reps++;
         lastRepCountedMs = now;
+
+        // Hand the rep to the radio right away; sent from bleUpdate()
+        RepSummary summary;
+        summary.rep = (uint16_t)reps;
+        summary.durationMs = (uint16_t)min(now - repStartMs, (uint32_t)UINT16_MAX);
+        summary.peakMmS = (uint16_t)(repPeak * 1000.0f);
+        summary.meanMmS = repSamples ? (uint16_t)(repSum / repSamples * 1000.0f) : 0;
+        summary.setTimeMs = now - setStartMs;
+        summary.detectedUs = micros();
+        telemetryPushRep(&summary);
+        soundRepTone(summary.meanMmS, summary.detectedUs);
+        repTable[(reps - 1) % REP_TABLE_SIZE] = summary;
+
+        repStartMs = now;
+        repPeak = 0.0f;
+        repSum = 0.0f;
+        repSamples = 0;
+
         Serial.printf("REP %d! v=%.3f gyro=%.1f sens=%s\n", 
                       reps, v, gyroMag, SENSITIVITY_NAMES[currentSensitivity]);
       }
@@ -397,6 +442,11 @@ uint32_t workoutGetRestTimeMs()  { return restTimeMs; }
 float workoutGetPeakVelocity()   { return peakVelocity; }
 int workoutGetReps()             { return reps; }
 
+const RepSummary* workoutGetRep(int rep) {
+  if (rep < 1 || rep > reps || reps - rep >= REP_TABLE_SIZE) return nullptr;
+  return &repTable[(rep - 1) % REP_TABLE_SIZE];
+}
+
 // ============================================================================
 // Storage
 // ============================================================================
@@ -410,15 +460,6 @@ bool workoutSave() {
     return false;
   }
 
-  // Create file with header if it doesn't exist
-  if (!fileExists(LOGFILE)) {
-    if (!createFile(LOGFILE, String(CSV_HEADER) + "\n")) {
-      Serial.println("Failed to create log file");
-      return false;
-    }
-    Serial.println("Created new log file with header");
-  }
-
   // Build CSV row
   char row[128];
   snprintf(row, sizeof(row), "%s,%d,%u,%u,%.3f,%s\n",
@@ -429,8 +470,8 @@ bool workoutSave() {
            peakVelocity,
            SENSITIVITY_NAMES[currentSensitivity]);
 
-  // Append to file
-  if (!appendToFile(LOGFILE, String(row))) {
+  // Append to the session log (created with header if needed)
+  if (!storageLogAppend(CSV_HEADER, row)) {
     Serial.println("Failed to append workout to log");
     return false;
   }
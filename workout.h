@@ -2,6 +2,7 @@
 #define WORKOUT_H
 
 #include <Arduino.h>
+#include "telemetry.h"
 
 // ---- Lifecycle ----
 
@@ -38,6 +39,10 @@ uint32_t workoutGetRestTimeMs();
 float workoutGetPeakVelocity();
 int workoutGetReps();
 
+// Summary of rep n (1-based) of the current set, or null once it has
+// dropped out of the rep table
+const RepSummary* workoutGetRep(int rep);
+
 // ---- Storage ----
 
 // Save current workout data to storage